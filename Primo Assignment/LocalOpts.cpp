@@ -9,6 +9,7 @@
 #include "llvm/Transforms/Utils/LocalOpts.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/InstrTypes.h"
+#include "llvm/IR/IRBuilder.h"
 
 using namespace llvm;
 
@@ -180,6 +181,93 @@ bool divOptimization (BasicBlock::iterator Iter) {
 }
 
 
+// Division by a runtime invariant (Granlund-Montgomery)
+//
+// Con l = ceil(log2 d) e m = floor(2^N * (2^l - d) / d) + 1, il quoziente
+// n / d è (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0), con t = mulhi(m, n).
+// Il calcolo di m richiede una divisione su 2N bit, quindi N <= 32
+
+bool isMagicDivisionCandidate (BinaryOperator *binIter) {
+   switch (binIter -> getOpcode()) {
+   case Instruction::UDiv:
+   case Instruction::SDiv:
+   case Instruction::URem:
+   case Instruction::SRem:
+      break;
+
+   default:
+      return false;
+   }
+
+   IntegerType *Ty = dyn_cast<IntegerType>(binIter -> getType());
+   if (not Ty or Ty -> getBitWidth() > 32) return false;
+
+   return not isa<Constant>(binIter -> getOperand(1));
+}
+
+
+MagicDivisor computeMagicDivisor (Value *Divisor, bool Signed, Instruction *InsertBefore) {
+   IRBuilder<> Builder(InsertBefore);
+   IntegerType *Ty = cast<IntegerType>(Divisor -> getType());
+   unsigned N = Ty -> getBitWidth();
+   IntegerType *WideTy = IntegerType::get(Ty -> getContext(), 2 * N);
+   Constant *One = ConstantInt::get(Ty, 1);
+
+   // Un divisore nullo è comportamento indefinito solo nell'istruzione
+   // originale: qui viene sostituito da 1 perché la divisione su 2N bit
+   // non generi trap
+   Value *D = Builder.CreateSelect(Builder.CreateIsNull(Divisor), One, Divisor);
+   if (Signed) D = Builder.CreateBinaryIntrinsic(Intrinsic::abs, D, Builder.getFalse());
+
+   Value *Clz = Builder.CreateBinaryIntrinsic(Intrinsic::ctlz, Builder.CreateSub(D, One), Builder.getFalse());
+   Value *Log = Builder.CreateSub(ConstantInt::get(Ty, N), Clz);
+
+   Value *WideD = Builder.CreateZExt(D, WideTy);
+   Value *Pow = Builder.CreateShl(ConstantInt::get(WideTy, 1), Builder.CreateZExt(Log, WideTy));
+   Value *Multiplier = Builder.CreateUDiv(Builder.CreateShl(Builder.CreateSub(Pow, WideD), N), WideD);
+
+   MagicDivisor Magic;
+   Magic.Multiplier = Builder.CreateAdd(Multiplier, ConstantInt::get(WideTy, 1), Divisor -> getName() + ".magic");
+   Magic.Shift1 = Builder.CreateBinaryIntrinsic(Intrinsic::umin, Log, One, nullptr, Divisor -> getName() + ".shift1");
+   Magic.Shift2 = Builder.CreateBinaryIntrinsic(Intrinsic::usub_sat, Log, One, nullptr, Divisor -> getName() + ".shift2");
+   Magic.Signed = Signed;
+
+   return Magic;
+}
+
+
+Value *expandMagicDivision (BinaryOperator *binIter, const MagicDivisor &Magic) {
+   IRBuilder<> Builder(binIter);
+   Value *Dividend = binIter -> getOperand(0);
+   Value *Divisor = binIter -> getOperand(1);
+   unsigned N = Dividend -> getType() -> getIntegerBitWidth();
+
+   // La divisione signed usa i valori assoluti; il segno del quoziente è
+   // quello di n xor d
+   Value *Sign = nullptr;
+   Value *Numerator = Dividend;
+
+   if (Magic.Signed) {
+      Sign = Builder.CreateAShr(Builder.CreateXor(Dividend, Divisor), N - 1);
+      Numerator = Builder.CreateBinaryIntrinsic(Intrinsic::abs, Dividend, Builder.getFalse());
+   }
+
+   Type *WideTy = Magic.Multiplier -> getType();
+   Value *Product = Builder.CreateMul(Magic.Multiplier, Builder.CreateZExt(Numerator, WideTy));
+   Value *High = Builder.CreateTrunc(Builder.CreateLShr(Product, N), Dividend -> getType());
+
+   Value *Quotient = Builder.CreateLShr(Builder.CreateSub(Numerator, High), Magic.Shift1);
+   Quotient = Builder.CreateLShr(Builder.CreateAdd(High, Quotient), Magic.Shift2);
+
+   if (Magic.Signed) Quotient = Builder.CreateSub(Builder.CreateXor(Quotient, Sign), Sign);
+
+   if (binIter -> getOpcode() == Instruction::URem or binIter -> getOpcode() == Instruction::SRem)
+      return Builder.CreateSub(Dividend, Builder.CreateMul(Quotient, Divisor));
+
+   return Quotient;
+}
+
+
 // Multi Instruction Optimization
 
 bool isOpposite (unsigned int op1, unsigned int op2) {
@@ -3,6 +3,7 @@
 
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/InstrTypes.h"
 
 namespace llvm {
 	class LocalOpts : public PassInfoMixin<LocalOpts> {
@@ -11,5 +12,18 @@ namespace llvm {
 	};
 } // namespace llvm
 
+// Moltiplicatore e shift per la divisione per un valore noto solo a runtime;
+// vengono calcolati una volta, ad esempio nel preheader di un loop
+struct MagicDivisor {
+   llvm::Value *Multiplier; // su 2N bit
+   llvm::Value *Shift1;
+   llvm::Value *Shift2;
+   bool Signed;
+};
+
+bool isMagicDivisionCandidate (llvm::BinaryOperator *binIter);
+MagicDivisor computeMagicDivisor (llvm::Value *Divisor, bool Signed, llvm::Instruction *InsertBefore);
+llvm::Value *expandMagicDivision (llvm::BinaryOperator *binIter, const MagicDivisor &Magic);
+
 
 #endif // LLVM_TRANSFORMS_LOCAL_OPTS_H
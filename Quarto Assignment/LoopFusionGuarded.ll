@@ -4,15 +4,15 @@ target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16
 target triple = "x86_64-unknown-linux-gnu"
 
 ; Function Attrs: noinline nounwind uwtable
-define dso_local void @calcoli(ptr noundef %0, ptr noundef %1, ptr noundef %2, ptr noundef %3, i32 noundef %4) #0 {
+define dso_local void @calcoli(ptr noalias noundef %0, ptr noalias noundef %1, ptr noalias noundef %2, ptr noalias noundef %3, i32 noundef %4) #0 {
   %6 = icmp sgt i32 %4, 0
-  br i1 %6, label %7, label %39
+  br i1 %6, label %7, label %33
 
 7:                                                ; preds = %5
   br label %8
 
-8:                                                ; preds = %20, %7
-  %.0 = phi i32 [ 0, %7 ], [ %19, %20 ]
+8:                                                ; preds = %30, %7
+  %.0 = phi i32 [ 0, %7 ], [ %19, %30 ]
   %9 = sext i32 %.0 to i64
   %10 = getelementptr inbounds i32, ptr %1, i64 %9
   %11 = load i32, ptr %10, align 4
@@ -25,44 +25,27 @@ define dso_local void @calcoli(ptr noundef %0, ptr noundef %1, ptr noundef %2, p
   %18 = getelementptr inbounds i32, ptr %0, i64 %17
   store i32 %16, ptr %18, align 4
   %19 = add nsw i32 %.0, 1
-  br label %26
-
-20:                                               ; preds = %26
-  %21 = icmp slt i32 %19, %4
-  br i1 %21, label %8, label %39
-
-22:                                               ; No predecessors!
-  br label %23
-
-23:                                               ; preds = %22
-  %24 = icmp sgt i32 %4, 0
-  br i1 %24, label %25, label %40
-
-25:                                               ; preds = %23
-  br label %26
-
-26:                                               ; preds = %8, %37, %25
+  %20 = sext i32 %.0 to i64
+  %21 = getelementptr inbounds i32, ptr %0, i64 %20
+  %22 = load i32, ptr %21, align 4
+  %23 = sext i32 %.0 to i64
+  %24 = getelementptr inbounds i32, ptr %2, i64 %23
+  %25 = load i32, ptr %24, align 4
+  %26 = add nsw i32 %22, %25
   %27 = sext i32 %.0 to i64
-  %28 = getelementptr inbounds i32, ptr %0, i64 %27
-  %29 = load i32, ptr %28, align 4
-  %30 = sext i32 %.0 to i64
-  %31 = getelementptr inbounds i32, ptr %2, i64 %30
-  %32 = load i32, ptr %31, align 4
-  %33 = add nsw i32 %29, %32
-  %34 = sext i32 %.0 to i64
-  %35 = getelementptr inbounds i32, ptr %3, i64 %34
-  store i32 %33, ptr %35, align 4
-  %36 = add nsw i32 %.0, 1
-  br label %20
+  %28 = getelementptr inbounds i32, ptr %3, i64 %27
+  store i32 %26, ptr %28, align 4
+  %29 = add nsw i32 %.0, 1
+  br label %30
 
-37:                                               ; No predecessors!
-  %38 = icmp slt i32 %36, %4
-  br i1 %38, label %26, label %39, !llvm.loop !6
+30:                                               ; preds = %8
+  %31 = icmp slt i32 %19, %4
+  br i1 %31, label %8, label %32, !llvm.loop !6
 
-39:                                               ; preds = %20, %5, %37
-  br label %40
+32:                                               ; preds = %30
+  br label %33
 
-40:                                               ; preds = %39, %23
+33:                                               ; preds = %5, %32
   ret void
 }
 
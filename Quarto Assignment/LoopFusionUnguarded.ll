@@ -4,13 +4,13 @@ target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16
 target triple = "x86_64-unknown-linux-gnu"
 
 ; Function Attrs: noinline nounwind uwtable
-define dso_local void @calcoli(i32 noundef %0, ptr noundef %1, ptr noundef %2, ptr noundef %3, ptr noundef %4) #0 {
+define dso_local void @calcoli(i32 noundef %0, ptr noalias noundef %1, ptr noalias noundef %2, ptr noalias noundef %3, ptr noalias noundef %4) #0 {
   br label %6
 
-6:                                                ; preds = %19, %5
-  %.0 = phi i32 [ 0, %5 ], [ %20, %19 ]
+6:                                                ; preds = %28, %5
+  %.0 = phi i32 [ 0, %5 ], [ %29, %28 ]
   %7 = icmp slt i32 %.0, %0
-  br i1 %7, label %8, label %36
+  br i1 %7, label %8, label %30
 
 8:                                                ; preds = %6
   %9 = sext i32 %.0 to i64
@@ -24,38 +24,23 @@ define dso_local void @calcoli(i32 noundef %0, ptr noundef %1, ptr noundef %2, p
   %17 = sext i32 %.0 to i64
   %18 = getelementptr inbounds i32, ptr %1, i64 %17
   store i32 %16, ptr %18, align 4
-  br label %24
-
-19:                                               ; preds = %24
-  %20 = add nsw i32 %.0, 1
+  %19 = sext i32 %.0 to i64
+  %20 = getelementptr inbounds i32, ptr %1, i64 %19
+  %21 = load i32, ptr %20, align 4
+  %22 = sext i32 %.0 to i64
+  %23 = getelementptr inbounds i32, ptr %3, i64 %22
+  %24 = load i32, ptr %23, align 4
+  %25 = add nsw i32 %21, %24
+  %26 = sext i32 %.0 to i64
+  %27 = getelementptr inbounds i32, ptr %4, i64 %26
+  store i32 %25, ptr %27, align 4
+  br label %28
+
+28:                                               ; preds = %8
+  %29 = add nsw i32 %.0, 1
   br label %6, !llvm.loop !6
 
-21:                                               ; No predecessors!
-  br label %22
-
-22:                                               ; preds = %34, %21
-  %.1 = phi i32 [ 0, %21 ], [ %35, %34 ]
-  %23 = icmp slt i32 %.0, %0
-  br label %34
-
-24:                                               ; preds = %8
-  %25 = sext i32 %.0 to i64
-  %26 = getelementptr inbounds i32, ptr %1, i64 %25
-  %27 = load i32, ptr %26, align 4
-  %28 = sext i32 %.0 to i64
-  %29 = getelementptr inbounds i32, ptr %3, i64 %28
-  %30 = load i32, ptr %29, align 4
-  %31 = add nsw i32 %27, %30
-  %32 = sext i32 %.0 to i64
-  %33 = getelementptr inbounds i32, ptr %4, i64 %32
-  store i32 %31, ptr %33, align 4
-  br label %19
-
-34:                                               ; preds = %22
-  %35 = add nsw i32 %.0, 1
-  br label %22, !llvm.loop !8
-
-36:                                               ; preds = %6
+30:                                               ; preds = %6
   ret void
 }
 
@@ -72,4 +57,3 @@ attributes #0 = { noinline nounwind uwtable "frame-pointer"="all" "min-legal-vec
 !5 = !{!"clang version 17.0.6"}
 !6 = distinct !{!6, !7}
 !7 = !{!"llvm.loop.mustprogress"}
-!8 = distinct !{!8, !7}
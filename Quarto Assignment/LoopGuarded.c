@@ -1,4 +1,4 @@
-void calcoli(int *a, int *b, int *c, int *d, int N) {
+void calcoli(int *restrict a, int *restrict b, int *restrict c, int *restrict d, int N) {
    int i=0;
 
    if (N > 0) {
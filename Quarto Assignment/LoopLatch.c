@@ -0,0 +1,9 @@
+void calcoli(int N, int *restrict a, int *restrict b, int *restrict c, int *restrict d) {
+   int i;
+
+   for (i=0; i<N; i++)
+      a[i] = 1/b[i]*c[i];
+
+   for (i=0; i<N; d[i] = a[i]+c[i], i++)
+      b[i] = a[i];
+}
@@ -1,4 +1,4 @@
-void calcoli(int N, int *a, int *b, int *c, int *d) {
+void calcoli(int N, int *restrict a, int *restrict b, int *restrict c, int *restrict d) {
    int i;
 
    for (i=0; i<N; i++)
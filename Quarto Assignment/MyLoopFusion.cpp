@@ -2,12 +2,49 @@
 
 using namespace llvm;
 
-bool isAdjacent(Loop *l0, Loop *l1) {
-   if (l0->isGuarded() && l1->isGuarded())
-      return (l0->getExitBlock()->getSingleSuccessor()==l1->getLoopGuardBranch()->getParent());
-   else if (!l0->isGuarded() && !l1->isGuarded())
-      return (l0->getExitBlock()==l1->getLoopPreheader());
-   return false;
+#define DEBUG_TYPE "my-loop-fusion"
+
+static cl::opt<unsigned> PeelThreshold(
+   "my-loop-fusion-peel-threshold", cl::init(4), cl::Hidden,
+   cl::desc("Numero massimo di iterazioni staccate dal primo loop per renderlo fondibile con il successivo"));
+
+static cl::opt<unsigned> ReuseDistance(
+   "my-loop-fusion-reuse-distance", cl::init(64), cl::Hidden,
+   cl::desc("Distanza massima in byte tra due accessi dei due loop allo stesso oggetto perché il dato venga riusato"));
+
+static cl::opt<unsigned> MinReusedBytes(
+   "my-loop-fusion-min-reused-bytes", cl::init(1), cl::Hidden,
+   cl::desc("Byte riusati per iterazione minimi perché la fusione sia conveniente"));
+
+static cl::opt<bool> IgnoreCost(
+   "my-loop-fusion-ignore-cost", cl::init(false), cl::Hidden,
+   cl::desc("Fonde i loop ogni volta che è legale, senza il modello di costo"));
+
+// Blocchi tra l0 e l1: senza guardia dall'uscita di l0 al preheader di l1,
+// con la guardia dal blocco in cui salta anche la guardia di l0 alla
+// guardia di l1. Devono formare una catena senza diramazioni né PHI; con la
+// guardia l'uscita di l0 e il preheader di l1 vengono eseguiti solo se il
+// loop viene eseguito e devono essere vuoti
+bool getInterveningBlocks(Loop *l0, Loop *l1, SmallVectorImpl<BasicBlock*> &Blocks) {
+   if (l0->isGuarded() != l1->isGuarded())   return false;
+
+   BasicBlock *BB = l0->getExitBlock();
+   BasicBlock *Last = l1->getLoopPreheader();
+
+   if (l0->isGuarded()) {
+      if (BB->size() != 1 || Last->size() != 1) return false;
+      BB = BB->getSingleSuccessor();
+      Last = l1->getLoopGuardBranch()->getParent();
+   }
+
+   while (true) {
+      if (!BB->phis().empty())   return false;
+      Blocks.push_back(BB);
+      if (BB == Last)   return true;
+
+      BB = BB->getSingleSuccessor();
+      if (!BB || !BB->getSinglePredecessor())   return false;
+   }
 }
 
 bool isSameIterations(Loop *l0, Loop *l1, ScalarEvolution &SE) {
@@ -25,115 +62,763 @@ bool isSameIterations(Loop *l0, Loop *l1, ScalarEvolution &SE) {
    return (trip_count0 == trip_count1);
 }
 
-bool isCFEq(Loop *l0, Loop *l1, DominatorTree &DT, PostDominatorTree &PDT) {
-   if (l0->isGuarded())
-      return (DT.dominates(l0->getLoopGuardBranch()->getParent(), l1->getLoopGuardBranch()->getParent()) &&
-      PDT.dominates(l1->getLoopGuardBranch()->getParent(), l0->getLoopGuardBranch()->getParent()));
-   else
-      return (DT.dominates(l0->getHeader(), l1->getHeader()) &&
-      PDT.dominates(l1->getHeader(), l0->getHeader()));
-}
-
-bool isNotNegDep(Loop *l0, Loop *l1) {
-   for (BasicBlock *BB0: l0->getBlocks())
-      for (Instruction &I0: *BB0)
-         if (I0.getOpcode() == Instruction::Store)
-            for (BasicBlock *BB1: l1->getBlocks())
-               for (Instruction &I1: *BB1)
-                  if (I1.getOpcode() == Instruction::Load) {
-                     GetElementPtrInst *GEP0 = dyn_cast<GetElementPtrInst>(I0.getOperand(1));
-                     GetElementPtrInst *GEP1 = dyn_cast<GetElementPtrInst>(I1.getOperand(0));
-                     // Controllo dei puntatori agli array
-                     if (GEP0->getPointerOperand() == GEP1->getPointerOperand()) {
-                        // Valutazione degli indici delle load e delle store 
-                        // Se sono PHINode rispettano il flusso del for
-                        SExtInst *S0 = dyn_cast<SExtInst>(GEP0->getOperand(1));
-                        SExtInst *S1 = dyn_cast<SExtInst>(GEP1->getOperand(1));
-                        PHINode *PN0 = dyn_cast<PHINode>(S0->getOperand(0));
-                        PHINode *PN1 = dyn_cast<PHINode>(S1->getOperand(0));
-                        if (!PN0)
-                           return false;
-                        if (!PN1) {
-                           Instruction *inst = dyn_cast<Instruction>(S1->getOperand(0));
-                           if (!inst || inst->getOpcode() != Instruction::Sub)
-                              return false;
-                        }
-                     }
-                  }
+// Induction variable del loop: l'unico PHI dell'header, una ricorrenza
+// affine con passo 1 e valore iniziale qualsiasi
+PHINode *getInductionVariable(Loop *L, ScalarEvolution &SE) {
+   BasicBlock *header = L->getHeader();
+   if (std::distance(header->phis().begin(), header->phis().end()) != 1)  return nullptr;
+
+   PHINode *IV = &*header->phis().begin();
+   if (!IV->getType()->isIntegerTy())  return nullptr;
+
+   const SCEVAddRecExpr *AR = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(IV));
+   if (!AR || AR->getLoop() != L || !AR->isAffine() || !AR->getStepRecurrence(SE)->isOne())  return nullptr;
+
+   return IV;
+}
+
+// Differenza costante tra i valori iniziali delle induction variable dopo
+// aver staccato Peel iterazioni da l0: nel loop fuso l'induction variable
+// di l1 diventa quella di l0 più questa differenza
+const SCEVConstant *getIVOffset(Loop *l0, Loop *l1, unsigned Peel, ScalarEvolution &SE) {
+   PHINode *IV0 = getInductionVariable(l0, SE);
+   PHINode *IV1 = getInductionVariable(l1, SE);
+   if (IV0->getType() != IV1->getType())  return nullptr;
+
+   const SCEV *Start0 = cast<SCEVAddRecExpr>(SE.getSCEV(IV0))->getStart();
+   const SCEV *Start1 = cast<SCEVAddRecExpr>(SE.getSCEV(IV1))->getStart();
+   Start0 = SE.getAddExpr(Start0, SE.getConstant(IV0->getType(), Peel));
+
+   return dyn_cast<SCEVConstant>(SE.getMinusSCEV(Start1, Start0));
+}
+
+// Iterazioni da staccare dall'inizio di l0 perché esegua lo stesso numero
+// di iterazioni di l1: i loop con la guardia devono avere lo stesso numero
+// di iterazioni, quelli senza possono differire di una costante, se il
+// primo loop è il più lungo. Le iterazioni staccate vengono eseguite prima
+// di entrambi i loop, come nel programma originale
+std::optional<unsigned> getPeelCount(Loop *l0, Loop *l1, ScalarEvolution &SE) {
+   std::optional<unsigned> Peel;
+
+   if (isSameIterations(l0, l1, SE))
+      Peel = 0;
+   else if (!l0->isGuarded() && !l1->isGuarded()) {
+      const SCEV *trip_count0 = SE.getBackedgeTakenCount(l0);
+      const SCEV *trip_count1 = SE.getBackedgeTakenCount(l1);
+      if (isa<SCEVCouldNotCompute>(trip_count0) || isa<SCEVCouldNotCompute>(trip_count1) || trip_count0->getType() != trip_count1->getType())  return std::nullopt;
+
+      // Il loop senza guardia esce dall'header: il numero di iterazioni è
+      // quello del backedge e le iterazioni staccate non devono mai uscire
+      const SCEVConstant *Diff = dyn_cast<SCEVConstant>(SE.getMinusSCEV(trip_count0, trip_count1));
+      if (!Diff || Diff->getAPInt().isNegative() || Diff->getAPInt().ugt(PeelThreshold))   return std::nullopt;
+      if (!SE.isKnownPredicate(ICmpInst::ICMP_UGE, trip_count0, Diff) || !canPeel(l0)) return std::nullopt;
+
+      Peel = Diff->getAPInt().getZExtValue();
+   }
+
+   if (!Peel || !getIVOffset(l0, l1, *Peel, SE))  return std::nullopt;
+   return Peel;
+}
+
+// Forma dei loop che loopFusion sa fondere: induction variable con passo 1
+// come unico PHI dell'header, un blocco di uscita e un corpo separato dal
+// latch. Senza guardia l'header è l'unico blocco che esce dal loop, con la
+// guardia è il latch
+bool isFusionCandidate(Loop *L, ScalarEvolution &SE) {
+   BasicBlock *header = L->getHeader();
+   BasicBlock *latch = L->getLoopLatch();
+
+   if (!L->getLoopPreheader() || !latch || latch == header || !L->getExitBlock())   return false;
+   if (!getInductionVariable(L, SE))  return false;
+
+   BasicBlock *lastBodyBB = latch->getSinglePredecessor();
+   if (!lastBodyBB || !L->contains(lastBodyBB) || lastBodyBB->getSingleSuccessor() != latch)  return false;
+
+   BasicBlock *exiting = L->isGuarded() ? latch : header;
+   BranchInst *BI = dyn_cast<BranchInst>(exiting->getTerminator());
+   if (L->getExitingBlock() != exiting || !BI || !BI->isConditional() || !L->contains(BI->getSuccessor(0)))  return false;
+
+   if (L->isGuarded())
+      return L->getLoopGuardBranch()->getSuccessor(0) == L->getLoopPreheader() && L->getExitBlock()->getSingleSuccessor();
+
+   return BI->getSuccessor(0) != latch && isa<BranchInst>(latch->getTerminator());
+}
+
+// Blocchi di l1 eliminati dalla fusione: il latch e, senza guardia,
+// l'header. Devono contenere solo il controllo del loop, cioè l'induction
+// variable, il suo incremento, il confronto di uscita e il salto, usati solo
+// tra loro. Il preheader di l1 è tra i blocchi intermedi, che
+// moveInterveningCode svuota, e l'uscita di l0 con la guardia deve essere
+// già vuota
+bool hasOnlyLoopControl(Loop *L, ScalarEvolution &SE) {
+   BasicBlock *header = L->getHeader();
+   BasicBlock *latch = L->getLoopLatch();
+   BasicBlock *exiting = L->isGuarded() ? latch : header;
+
+   PHINode *IV = getInductionVariable(L, SE);
+   Value *Inc = IV->getIncomingValueForBlock(latch);
+   Value *Cond = cast<BranchInst>(exiting->getTerminator())->getCondition();
+
+   auto isLoopControl = [&](Instruction &I) {
+      if (&I == IV || I.isTerminator())   return true;
+      if (&I != Inc && &I != Cond)  return false;
+
+      return all_of(I.users(), [&](User *U) {
+         return U == IV || U == Cond || U == exiting->getTerminator();
+      });
+   };
+
+   for (Instruction &I : latch->instructionsWithoutDebug())
+      if (!isLoopControl(I))  return false;
+
+   if (!L->isGuarded())
+      for (Instruction &I : header->instructionsWithoutDebug())
+         if (!isLoopControl(I))  return false;
+
+   return true;
+}
+
+// Blocco usato per i controlli di control flow equivalence
+BasicBlock *getEntryBlock(Loop *L) {
+   if (L->isGuarded())
+      return L->getLoopGuardBranch()->getParent();
+   return L->getHeader();
+}
+
+// Due blocchi A e B sono control flow equivalenti se A domina B e B
+// post-domina A. Risalendo l'albero dei dominatori finché il blocco
+// post-domina il dominatore si ottiene lo stesso blocco per tutti i blocchi
+// equivalenti, usato come chiave dell'insieme di candidati
+BasicBlock *getCFEqRoot(BasicBlock *BB, DominatorTree &DT, PostDominatorTree &PDT) {
+   DomTreeNode *N = DT.getNode(BB);
+
+   while (N->getIDom() && PDT.dominates(BB, N->getIDom()->getBlock()))
+      N = N->getIDom();
+
+   return N->getBlock();
+}
+
+// Le ricorrenze di l1 vengono riscritte come ricorrenze di l0, così gli
+// indirizzi dei due loop sono confrontabili alla stessa iterazione del loop
+// fuso. I flag di nowrap valgono per le iterazioni di l1 e non per quelle di
+// l0, che prima di staccare le iterazioni sono di più: le ricorrenze
+// riscritte non ne hanno, altrimenti ScalarEvolution li aggiungerebbe anche
+// a un'espressione identica di l0
+class AddRecLoopReplacer : public SCEVRewriteVisitor<AddRecLoopReplacer> {
+   const Loop *OldL, *NewL;
+
+   public:
+      AddRecLoopReplacer(ScalarEvolution &SE, const Loop *OldL, const Loop *NewL) : SCEVRewriteVisitor(SE), OldL(OldL), NewL(NewL) {}
+
+      const SCEV *visitAddRecExpr(const SCEVAddRecExpr *Expr) {
+         SmallVector<const SCEV*> Operands;
+         for (const SCEV *Op : Expr->operands())
+            Operands.push_back(visit(Op));
+
+         const Loop *L = Expr->getLoop() == OldL ? NewL : Expr->getLoop();
+         return SE.getAddRecExpr(Operands, L, SCEV::FlagAnyWrap);
+      }
+};
+
+// Load o store di un loop con il suo indirizzo
+struct MemAccess {
+   Instruction *I;
+   const SCEV *Ptr;
+};
+
+// Accessi alla memoria di un loop raggruppati per oggetto di base, calcolati
+// una sola volta per loop. Gli oggetti identificati (alloca, globali,
+// argomenti noalias) diversi non sono mai alias, quindi i loro accessi non
+// vengono confrontati
+struct AccessSummary {
+   // Falso se il loop contiene call o accessi volatili o atomici
+   bool Valid = true;
+   MapVector<const Value*, SmallVector<MemAccess>> Objects;
+   // Oggetti non identificati, che possono essere alias di qualsiasi altro
+   SmallVector<const Value*> Unidentified;
+};
+
+AccessSummary summarizeAccesses(Loop *L, ScalarEvolution &SE) {
+   AccessSummary Summary;
+
+   for (BasicBlock *BB : L->blocks())
+      for (Instruction &I : *BB) {
+         if (!I.mayReadOrWriteMemory())   continue;
+
+         if (LoadInst *LI = dyn_cast<LoadInst>(&I)) {
+            if (!LI->isSimple()) Summary.Valid = false;
+         } else if (StoreInst *SI = dyn_cast<StoreInst>(&I)) {
+            if (!SI->isSimple()) Summary.Valid = false;
+         } else
+            Summary.Valid = false;
+
+         if (!Summary.Valid)  return Summary;
+
+         Value *Ptr = getLoadStorePointerOperand(&I);
+         const Value *Obj = getUnderlyingObject(Ptr);
+
+         auto Inserted = Summary.Objects.insert({Obj, {}});
+         if (Inserted.second && !isIdentifiedObject(Obj))
+            Summary.Unidentified.push_back(Obj);
+
+         Inserted.first->second.push_back({&I, SE.getSCEV(Ptr)});
+      }
+
+   return Summary;
+}
+
+// Nel loop fuso l'iterazione i di l1 viene eseguita dopo l'iterazione i di
+// l0 ma prima delle successive: una dipendenza tra A0 e A1 è rispettata se
+// l'iterazione di l1 che accede alla locazione scritta o letta da l0 non
+// precede quella di l0. Con indirizzi {B0,+,S} e {B1,+,S} e accessi di
+// dimensione al massimo |S| questo vale se B0 - B1 ha lo stesso segno di S.
+// Staccando Peel iterazioni da l0 l'indirizzo iniziale diventa B0 + Peel*S
+bool isForwardAccessPair(const MemAccess &A0, const MemAccess &A1, Loop *l0, Loop *l1, unsigned Peel, ScalarEvolution &SE) {
+   const DataLayout &DL = A0.I->getModule()->getDataLayout();
+   TypeSize Size = DL.getTypeStoreSize(getLoadStoreType(A0.I));
+   if (Size != DL.getTypeStoreSize(getLoadStoreType(A1.I)) || Size.isScalable()) return false;
+
+   AddRecLoopReplacer Rewriter(SE, l1, l0);
+   const SCEVAddRecExpr *Ptr0 = dyn_cast<SCEVAddRecExpr>(A0.Ptr);
+   const SCEVAddRecExpr *Ptr1 = dyn_cast<SCEVAddRecExpr>(Rewriter.visit(A1.Ptr));
+
+   // Gli indirizzi devono essere ricorrenze affini del loop fuso con lo
+   // stesso passo; per gli array a più dimensioni gli indici dei loop
+   // esterni compaiono nell'indirizzo iniziale
+   if (!Ptr0 || !Ptr1 || Ptr0->getLoop() != l0 || Ptr1->getLoop() != l0)  return false;
+   if (!Ptr0->isAffine() || !Ptr1->isAffine())  return false;
+
+   const SCEV *Step = Ptr0->getStepRecurrence(SE);
+   if (Step != Ptr1->getStepRecurrence(SE))  return false;
+
+   const SCEV *Start0 = SE.getAddExpr(Ptr0->getStart(), SE.getMulExpr(Step, SE.getConstant(Step->getType(), Peel)));
+   const SCEV *Dist = SE.getMinusSCEV(Start0, Ptr1->getStart());
+   if (isa<SCEVCouldNotCompute>(Dist))  return false;
+
+   const SCEV *AccessSize = SE.getConstant(Step->getType(), Size.getFixedValue());
+
+   if (SE.isKnownPredicate(ICmpInst::ICMP_SGE, Step, AccessSize))
+      return SE.isKnownNonNegative(Dist);
+   if (SE.isKnownPredicate(ICmpInst::ICMP_SLE, Step, SE.getNegativeSCEV(AccessSize)))
+      return SE.isKnownNonPositive(Dist);
+
+   return false;
+}
+
+// Ogni coppia di accessi di l0 e l1 in cui almeno uno scrive in memoria
+// deve rispettare l'ordine originale: la store di l0 prima della load o
+// store di l1 (flow e output), la load di l0 prima della store di l1 (anti).
+// Se il confronto degli indirizzi non basta, DependenceInfo, che usa anche
+// l'alias analysis, può ancora escludere la dipendenza in qualsiasi
+// iterazione
+bool isNotNegDep(const SmallVectorImpl<MemAccess> &Accesses0, const SmallVectorImpl<MemAccess> &Accesses1, Loop *l0, Loop *l1, unsigned Peel, DependenceInfo &DI, ScalarEvolution &SE) {
+   for (const MemAccess &A0 : Accesses0)
+      for (const MemAccess &A1 : Accesses1)
+         if (isa<StoreInst>(A0.I) || isa<StoreInst>(A1.I))
+            if (!isForwardAccessPair(A0, A1, l0, l1, Peel, SE) && DI.depends(A0.I, A1.I, true))
+               return false;
+
+   return true;
+}
+
+// Gli accessi di l0 vengono confrontati solo con quelli di l1 allo stesso
+// oggetto e con quelli a oggetti non identificati
+bool isNotNegDep(Loop *l0, Loop *l1, unsigned Peel, AccessSummary &S0, AccessSummary &S1, DependenceInfo &DI, ScalarEvolution &SE) {
+   if (!S0.Valid || !S1.Valid)   return false;
+
+   for (auto &Object : S0.Objects) {
+      if (!isIdentifiedObject(Object.first)) {
+         for (auto &Other : S1.Objects)
+            if (!isNotNegDep(Object.second, Other.second, l0, l1, Peel, DI, SE))  return false;
+         continue;
+      }
+
+      auto Same = S1.Objects.find(Object.first);
+      if (Same != S1.Objects.end() && !isNotNegDep(Object.second, Same->second, l0, l1, Peel, DI, SE))   return false;
+
+      for (const Value *Obj : S1.Unidentified)
+         if (!isNotNegDep(Object.second, S1.Objects.find(Obj)->second, l0, l1, Peel, DI, SE))  return false;
+   }
+
    return true;
 }
 
-void loopFusion(Loop *l0, Loop *l1) {
-   PHINode *IV0 = l0->getCanonicalInductionVariable();
-   PHINode *IV1 = l1->getCanonicalInductionVariable();
-   IV1->replaceAllUsesWith(IV0);
+// Un valore calcolato in l0 e usato da l1, direttamente o attraverso il
+// codice tra i due loop, è quello dell'ultima iterazione di l0: nel loop
+// fuso l1 vedrebbe invece quello dell'iterazione corrente
+bool hasScalarDependence(Loop *l0, Loop *l1, ArrayRef<BasicBlock*> Between) {
+   SmallPtrSet<Instruction*, 8> FromL0;
+
+   auto usesL0 = [&](Instruction &I) {
+      return any_of(I.operands(), [&](Value *V) {
+         Instruction *Op = dyn_cast<Instruction>(V);
+         return Op && (l0->contains(Op) || FromL0.count(Op));
+      });
+   };
+
+   for (BasicBlock *BB : Between)
+      for (Instruction &I : *BB)
+         if (usesL0(I))   FromL0.insert(&I);
+
+   for (BasicBlock *BB : l1->blocks())
+      for (Instruction &I : *BB)
+         if (usesL0(I))   return true;
+
+   return false;
+}
+
+// Ricorrenza di l0 dopo aver staccato Peel iterazioni
+const SCEV *getPeeledAddRec(const SCEV *S, unsigned Peel, ScalarEvolution &SE) {
+   const SCEVAddRecExpr *AR = dyn_cast<SCEVAddRecExpr>(S);
+   if (!Peel || !AR || !AR->isAffine())   return S;
+
+   const SCEV *Start = AR->evaluateAtIteration(SE.getConstant(AR->getType(), Peel), SE);
+   return SE.getAddRecExpr(Start, AR->getStepRecurrence(SE), AR->getLoop(), SCEV::FlagAnyWrap);
+}
+
+// Guadagno della fusione: byte per iterazione a cui l1 accede a distanza
+// costante, al massimo ReuseDistance, da un accesso di l0 alla stessa
+// iterazione del loop fuso. Nel loop fuso questi dati sono ancora in cache
+// o in un registro invece di essere riletti dalla memoria dopo la fine di l0
+unsigned getReusedBytes(Loop *l0, Loop *l1, unsigned Peel, AccessSummary &S0, AccessSummary &S1, ScalarEvolution &SE) {
+   const DataLayout &DL = l0->getHeader()->getModule()->getDataLayout();
+   AddRecLoopReplacer Rewriter(SE, l1, l0);
+   unsigned Bytes = 0;
+
+   for (auto &Object : S1.Objects) {
+      auto Same = S0.Objects.find(Object.first);
+      if (Same == S0.Objects.end()) continue;
+
+      for (const MemAccess &A1 : Object.second) {
+         const SCEV *Ptr1 = Rewriter.visit(A1.Ptr);
+
+         bool Reused = any_of(Same->second, [&](const MemAccess &A0) {
+            const SCEVConstant *Dist = dyn_cast<SCEVConstant>(SE.getMinusSCEV(getPeeledAddRec(A0.Ptr, Peel, SE), Ptr1));
+            return Dist && Dist->getAPInt().abs().ule(ReuseDistance);
+         });
+
+         if (Reused)
+            Bytes += DL.getTypeStoreSize(getLoadStoreType(A1.I)).getKnownMinValue();
+      }
+   }
+
+   return Bytes;
+}
+
+// Valori che occupano un registro per tutto il loop: i PHI dell'header e i
+// valori definiti fuori dal loop usati al suo interno
+void collectLiveValues(Loop *L, SmallPtrSetImpl<Value*> &Live) {
+   for (PHINode &PN : L->getHeader()->phis())
+      Live.insert(&PN);
+
+   for (BasicBlock *BB : L->blocks())
+      for (Instruction &I : *BB)
+         for (Use &O : I.operands()) {
+            Instruction *OI = dyn_cast<Instruction>(O);
+            if (isa<Argument>(O) || (OI && !L->contains(OI)))   Live.insert(O);
+         }
+}
+
+// Costo della fusione: byte per iterazione dei registri che il loop fuso
+// usa in più rispetto al maggiore dei due loop e che superano quelli
+// disponibili per la loro classe, da salvare e ricaricare ad ogni iterazione.
+// L'induction variable di l1 viene sostituita da quella di l0
+unsigned getSpilledBytes(Loop *l0, Loop *l1, ScalarEvolution &SE, TargetTransformInfo &TTI) {
+   SmallPtrSet<Value*, 32> Live0, Live1;
+   collectLiveValues(l0, Live0);
+   collectLiveValues(l1, Live1);
+   Live1.erase(getInductionVariable(l1, SE));
+
+   DenseMap<unsigned, unsigned> Pressure0, Pressure1, FusedPressure;
+   for (Value *V : Live0) {
+      unsigned ClassID = TTI.getRegisterClassForType(V->getType()->isVectorTy(), V->getType());
+      Pressure0[ClassID]++;
+      FusedPressure[ClassID]++;
+   }
+   for (Value *V : Live1) {
+      unsigned ClassID = TTI.getRegisterClassForType(V->getType()->isVectorTy(), V->getType());
+      Pressure1[ClassID]++;
+      if (!Live0.count(V))  FusedPressure[ClassID]++;
+   }
+
+   unsigned RegBytes = TTI.getRegisterBitWidth(TargetTransformInfo::RGK_Scalar).getFixedValue() / 8;
+   unsigned Bytes = 0;
+
+   for (auto &P : FusedPressure) {
+      unsigned Available = std::max({TTI.getNumberOfRegisters(P.first), Pressure0[P.first], Pressure1[P.first]});
+      if (P.second > Available)
+         Bytes += (P.second - Available) * RegBytes;
+   }
+
+   return Bytes;
+}
+
+// I blocchi di l1 che restano nel loop fuso passano a l0, i sottoloop di l1
+// diventano sottoloop di l0 e l1 viene eliminato da LoopInfo
+void mergeLoops(Loop *l0, Loop *l1, LoopInfo &LI) {
+   SmallVector<BasicBlock*> Blocks(l1->blocks());
+
+   for (BasicBlock *BB : Blocks) {
+      l0->addBlockEntry(BB);
+      l1->removeBlockFromLoop(BB);
+      if (LI.getLoopFor(BB) == l1)
+         LI.changeLoopFor(BB, l0);
+   }
+
+   while (!l1->isInnermost()) {
+      Loop *Child = *l1->begin();
+      l1->removeChildLoop(l1->begin());
+      l0->addChildLoop(Child);
+   }
+
+   LI.erase(l1);
+}
+
+void loopFusion(Loop *l0, Loop *l1, DomTreeUpdater &DTU, LoopInfo &LI, ScalarEvolution &SE) {
+   PHINode *IV0 = getInductionVariable(l0, SE);
+   PHINode *IV1 = getInductionVariable(l1, SE);
+   const SCEVConstant *Offset = getIVOffset(l0, l1, 0, SE);
+
+   // Il numero di iterazioni e le espressioni dei due loop cambiano
+   SE.forgetLoop(l0);
+   SE.forgetLoop(l1);
 
    BasicBlock *header0 = l0->getHeader();
+
+   // Le due induction variable hanno lo stesso passo: se i valori iniziali
+   // sono diversi quella di l1 viene calcolata da quella di l0
+   Value *NewIV1 = IV0;
+   if (!Offset->isZero())
+      NewIV1 = BinaryOperator::CreateAdd(IV0, Offset->getValue(), IV1->getName(), &*header0->getFirstInsertionPt());
+   IV1->replaceAllUsesWith(NewIV1);
+
    BasicBlock *header1 = l1->getHeader();
    BasicBlock *latch0 = l0->getLoopLatch();
    BasicBlock *latch1 = l1->getLoopLatch();
    BasicBlock *exit = l1->getUniqueExitBlock();
+
+   // Dopo una fusione i blocchi del loop fuso non sono più nell'ordine del
+   // CFG, quindi il corpo viene individuato a partire dal latch
+   BasicBlock *lastL0BodyBB = latch0->getSinglePredecessor();
+   BasicBlock *lastL1BodyBB = latch1->getSinglePredecessor();
+   // Con la guardia il corpo di l1 inizia dall'header, altrimenti dal
+   // blocco successivo
+   BasicBlock *firstL1BodyBB = header1;
+
+   // Archi modificati, applicati ai dominatori e ai post-dominatori
+   SmallVector<DominatorTree::UpdateType> Updates;
+   // Blocchi che dopo la fusione non sono più raggiungibili
+   SmallSetVector<BasicBlock*, 4> DeadBlocks;
    
    if (!l0->isGuarded()) {
       // Modify CFG as follows:
       // header 0 --> L1 exit
       // body 0 --> body 1
       // body 1 --> latch 0
-      // header 1 --> latch 1
-      BasicBlock* lastL0BodyBB = l0->getBlocks().drop_back(1).back();
+      // preheader 1, header 1 and latch 1 are deleted
+      BasicBlock *preheader1 = l1->getLoopPreheader();
+      firstL1BodyBB = header1->getTerminator()->getSuccessor(0);
 
       // Attach body 1 to body 0
-      lastL0BodyBB->getTerminator()->setSuccessor(0, l1->getBlocks().drop_front(1).drop_back(1).front());
+      lastL0BodyBB->getTerminator()->setSuccessor(0, firstL1BodyBB);
+      Updates.push_back({DominatorTree::Delete, lastL0BodyBB, latch0});
+      Updates.push_back({DominatorTree::Insert, lastL0BodyBB, firstL1BodyBB});
 
       // Attach latch 0 to body 1
-      l1->getBlocks().drop_front(1).drop_back(1).back()->getTerminator()->setSuccessor(0, latch0);
-
-      // Attach header 1 to latch 1
-      BranchInst::Create(latch1, header1->getTerminator());
-      header1->getTerminator()->eraseFromParent();
+      lastL1BodyBB->getTerminator()->setSuccessor(0, latch0);
+      Updates.push_back({DominatorTree::Delete, lastL1BodyBB, latch1});
+      Updates.push_back({DominatorTree::Insert, lastL1BodyBB, latch0});
 
       // Attach header 0 to L1 exit
-      BranchInst::Create(l0->getBlocks().drop_front(1).front(), exit, header0->back().getOperand(0), header0->getTerminator());
-      header0->getTerminator()->eraseFromParent();
+      header0->getTerminator()->setSuccessor(1, exit);
+      exit->replacePhiUsesWith(header1, header0);
+      Updates.push_back({DominatorTree::Delete, header0, preheader1});
+      Updates.push_back({DominatorTree::Insert, header0, exit});
+
+      DeadBlocks.insert(preheader1);
+      DeadBlocks.insert(header1);
+      DeadBlocks.insert(latch1);
    } else {
       // guard0 --> L1 exit
       // latch0 --> L1 exit
       // header0 --> header1
       // header1 --> latch0
+      // L0 exit, guard 1, preheader 1 and latch 1 are deleted
 
       BasicBlock *guard0 = l0->getLoopGuardBranch()->getParent();
       BasicBlock *guard1 = l1->getLoopGuardBranch()->getParent();
       BasicBlock *preheader1 = l1->getLoopPreheader();
+      BasicBlock *exit0 = l0->getExitBlock();
+      BasicBlock *skip0 = guard0->getTerminator()->getSuccessor(1);
 
       // Attach guard 0 to L1 exit
-      BranchInst::Create(l0->getLoopPreheader(), exit->getSingleSuccessor(), guard0->back().getOperand(0), guard0->getTerminator());
-      guard0->getTerminator()->eraseFromParent();
+      guard0->getTerminator()->setSuccessor(1, exit->getSingleSuccessor());
+      exit->getSingleSuccessor()->replacePhiUsesWith(guard1, guard0);
+      Updates.push_back({DominatorTree::Delete, guard0, skip0});
+      Updates.push_back({DominatorTree::Insert, guard0, exit->getSingleSuccessor()});
 
       // Attach latch 0 to L1 exit
-      BranchInst::Create(l0->getBlocks().front(), exit, latch0->back().getOperand(0), latch0->getTerminator());
-      latch0->getTerminator()->eraseFromParent();
+      latch0->getTerminator()->setSuccessor(1, exit);
+      exit->replacePhiUsesWith(latch1, latch0);
+      Updates.push_back({DominatorTree::Delete, latch0, exit0});
+      Updates.push_back({DominatorTree::Insert, latch0, exit});
 
       // Attach header 0 to header 1
-      l0->getBlocks().drop_back(1).back()->getTerminator()->setSuccessor(0, l1->getBlocks().front());
+      lastL0BodyBB->getTerminator()->setSuccessor(0, header1);
+      Updates.push_back({DominatorTree::Delete, lastL0BodyBB, latch0});
+      Updates.push_back({DominatorTree::Insert, lastL0BodyBB, header1});
 
       // Attach header 1 to latch 0
-      l1->getBlocks().drop_back(1).back()->getTerminator()->setSuccessor(0, latch0);
+      lastL1BodyBB->getTerminator()->setSuccessor(0, latch0);
+      Updates.push_back({DominatorTree::Delete, lastL1BodyBB, latch1});
+      Updates.push_back({DominatorTree::Insert, lastL1BodyBB, latch0});
 
       // Remove header 1 PHI node
-      header1->front().eraseFromParent();
+      IV1->eraseFromParent();
+
+      DeadBlocks.insert(exit0);
+      DeadBlocks.insert(guard1);
+      DeadBlocks.insert(preheader1);
+      DeadBlocks.insert(latch1);
+   }
 
-      // Attach preheader 1 to latch 1
-      BranchInst::Create(latch1, preheader1->getTerminator());
-      preheader1->getTerminator()->eraseFromParent();
+   DTU.applyUpdates(Updates);
 
-      // Attach latch 1 to guard 1
-      BranchInst::Create(guard1, latch1->getTerminator());
-      latch1->getTerminator()->eraseFromParent();
+   for (BasicBlock *BB : DeadBlocks)
+      LI.removeBlock(BB);
 
-      // Attachh guard 1 to preheader 1
-      BranchInst::Create(preheader1, guard1->getTerminator());
-      guard1->getTerminator()->eraseFromParent();
+   mergeLoops(l0, l1, LI);
+
+   // I blocchi non raggiungibili vengono eliminati anche dai dominatori
+   DeleteDeadBlocks(DeadBlocks.getArrayRef(), &DTU);
+
+   // Il primo blocco del corpo di l1 viene unito all'ultimo di l0: se l0 e
+   // l1 terminano e iniziano con un sottoloop, i due sottoloop diventano
+   // adiacenti e possono essere fusi a loro volta
+   MergeBlockIntoPredecessor(firstL1BodyBB, &DTU, &LI);
+}
+
+// Sposta le istruzioni tra i due loop prima di l0 se possibile, altrimenti
+// dopo l1, e unisce i blocchi rimasti vuoti: al termine i due loop sono
+// adiacenti. isSafeToMoveBefore controlla la control flow equivalence, la
+// dominanza di operandi e usi e le dipendenze con tutte le istruzioni
+// attraversate, compresi i corpi dei loop. Le istruzioni vengono spostate
+// una alla volta, in ordine di programma verso l'alto e in ordine inverso
+// verso il basso, così una catena di istruzioni dipendenti si sposta
+// insieme. Se un'istruzione non può essere spostata o un blocco non può
+// essere unito restituisce false: le istruzioni già spostate restano in una
+// posizione comunque corretta e Changed lo segnala
+bool moveInterveningCode(Loop *l0, Loop *l1, ArrayRef<BasicBlock*> Blocks, DominatorTree &DT, PostDominatorTree &PDT, DomTreeUpdater &DTU, LoopInfo &LI, DependenceInfo &DI, bool &Changed) {
+   BasicBlock *exit1 = l1->getExitBlock();
+   Instruction *HoistPt = l0->isGuarded() ? l0->getLoopGuardBranch() : l0->getLoopPreheader()->getTerminator();
+   Instruction *SinkPt = &*(l1->isGuarded() ? exit1->getSingleSuccessor() : exit1)->getFirstInsertionPt();
+   // La condizione della guardia di l1 resta nel suo blocco, che viene
+   // eliminato dalla fusione
+   Value *GuardCond = l1->isGuarded() ? l1->getLoopGuardBranch()->getCondition() : nullptr;
+
+   SmallVector<Instruction*> Rest;
+   for (BasicBlock *BB : Blocks)
+      for (Instruction &I : make_early_inc_range(*BB)) {
+         if (I.isTerminator() || &I == GuardCond)  continue;
+
+         if (isSafeToMoveBefore(I, *HoistPt, DT, &PDT, &DI)) {
+            I.moveBefore(HoistPt);
+            Changed = true;
+         } else
+            Rest.push_back(&I);
+      }
+
+   for (Instruction *I : reverse(Rest)) {
+      if (!isSafeToMoveBefore(*I, *SinkPt, DT, &PDT, &DI))   return false;
+
+      I->moveBefore(SinkPt);
+      SinkPt = I;
+      Changed = true;
+   }
+
+   for (BasicBlock *BB : drop_begin(Blocks)) {
+      if (!MergeBlockIntoPredecessor(BB, &DTU, &LI))   return false;
+      Changed = true;
    }
+
+   return true;
+}
+
+// Stacca Peel iterazioni dall'inizio di un loop senza guardia. peelLoop
+// lascia in ogni iterazione staccata il controllo di uscita dell'header,
+// che con almeno Peel iterazioni non viene mai preso: viene eliminato, e il
+// blocco di uscita dedicato creato da peelLoop viene unito a quello
+// originale, così il loop resta adiacente al successivo. Restituisce false se
+// i due blocchi di uscita non possono essere uniti
+bool peelIterations(Loop *L, unsigned Peel, DominatorTree &DT, PostDominatorTree &PDT, DomTreeUpdater &DTU, LoopInfo &LI, ScalarEvolution &SE) {
+   BasicBlock *exit = L->getExitBlock();
+   ValueToValueMapTy VMap;
+
+   peelLoop(L, Peel, &LI, &SE, DT, nullptr, false, VMap);
+   // peelLoop aggiorna solo i dominatori
+   PDT.recalculate(*exit->getParent());
+
+   SmallVector<DominatorTree::UpdateType> Updates;
+   for (BasicBlock *Pred : SmallVector<BasicBlock*>(predecessors(exit))) {
+      BranchInst *BI = dyn_cast<BranchInst>(Pred->getTerminator());
+      if (L->contains(Pred) || !BI || !BI->isConditional())  continue;
+
+      BasicBlock *Next = BI->getSuccessor(0) == exit ? BI->getSuccessor(1) : BI->getSuccessor(0);
+      exit->removePredecessor(Pred);
+      BranchInst::Create(Next, BI);
+      BI->eraseFromParent();
+      Updates.push_back({DominatorTree::Delete, Pred, exit});
+   }
+
+   DTU.applyUpdates(Updates);
+   // Il valore iniziale dell'induction variable e il numero di iterazioni
+   // cambiano
+   SE.forgetLoop(L);
+
+   return MergeBlockIntoPredecessor(exit, &DTU, &LI);
+}
+
+// Dopo lo spostamento del codice e il distacco delle iterazioni i due loop
+// devono essere nella forma gestita da loopFusion, con lo stesso numero di
+// iterazioni e separati da un solo blocco, eliminato dalla fusione: senza
+// guardia contiene solo il salto, con la guardia anche la condizione della
+// guardia di l1
+bool isReadyForFusion(Loop *l0, Loop *l1, ScalarEvolution &SE) {
+   if (!isFusionCandidate(l0, SE) || !isFusionCandidate(l1, SE) || !hasOnlyLoopControl(l1, SE))  return false;
+   if (!isSameIterations(l0, l1, SE) || !getIVOffset(l0, l1, 0, SE))  return false;
+
+   SmallVector<BasicBlock*> Between;
+   if (!getInterveningBlocks(l0, l1, Between) || Between.size() != 1)  return false;
+
+   Instruction *GuardCond = l1->isGuarded() ? dyn_cast<Instruction>(l1->getLoopGuardBranch()->getCondition()) : nullptr;
+   return all_of(*Between.front(), [&](Instruction &I) {
+      return I.isTerminator() || (&I == GuardCond && I.hasOneUse());
+   });
+}
+
+// Controlli di legalità e di convenienza della fusione di L0 con L1, con un
+// remark per ogni decisione. Il codice tra i due loop viene spostato solo
+// dopo gli altri controlli, che non dipendono dalla sua posizione, poi
+// vengono staccate le iterazioni di L0 e i due loop vengono controllati di
+// nuovo. Moved segnala se il codice è stato modificato
+bool prepareFusion(Loop *L0, Loop *L1, AccessSummary &S0, AccessSummary &S1, DominatorTree &DT, PostDominatorTree &PDT, DomTreeUpdater &DTU, LoopInfo &LI, ScalarEvolution &SE, DependenceInfo &DI, TargetTransformInfo &TTI, OptimizationRemarkEmitter &ORE, bool &Moved) {
+   auto Missed = [&](StringRef Name, StringRef Msg) {
+      ORE.emit([&]() {
+         return OptimizationRemarkMissed(DEBUG_TYPE, Name, L0->getStartLoc(), L0->getHeader()) << Msg;
+      });
+      return false;
+   };
+
+   SmallVector<BasicBlock*> Between;
+   if (!getInterveningBlocks(L0, L1, Between))
+      return Missed("NotAdjacent", "il loop successivo non è separato solo da codice senza diramazioni");
+
+   if (!hasOnlyLoopControl(L1, SE))
+      return Missed("LoopControl", "l'header o il latch del loop successivo contengono istruzioni oltre al controllo del loop");
+
+   if (hasScalarDependence(L0, L1, Between))
+      return Missed("ScalarDependence", "il loop successivo usa un valore calcolato da questo loop");
+
+   std::optional<unsigned> Peel = getPeelCount(L0, L1, SE);
+   if (!Peel)
+      return Missed("TripCount", "i due loop non eseguono lo stesso numero di iterazioni");
+
+   if (!isNotNegDep(L0, L1, *Peel, S0, S1, DI, SE))
+      return Missed("Dependence", "la fusione violerebbe una dipendenza tra i due loop");
+
+   unsigned Reused = getReusedBytes(L0, L1, *Peel, S0, S1, SE);
+   unsigned Spilled = getSpilledBytes(L0, L1, SE, TTI);
+
+   if (!IgnoreCost && (Reused < MinReusedBytes || Reused <= Spilled)) {
+      ORE.emit([&]() {
+         return OptimizationRemarkMissed(DEBUG_TYPE, "NotProfitable", L0->getStartLoc(), L0->getHeader())
+            << "fusione non conveniente: " << ore::NV("ReusedBytes", Reused) << " byte riusati per iterazione contro "
+            << ore::NV("SpilledBytes", Spilled) << " byte di registri salvati in memoria";
+      });
+      return false;
+   }
+
+   if (!moveInterveningCode(L0, L1, Between, DT, PDT, DTU, LI, DI, Moved))
+      return Missed("CodeNotMovable", "il codice tra i due loop non può essere spostato");
+
+   // Il codice spostato può cambiare le espressioni dei due loop, per
+   // esempio il loro numero di iterazioni
+   if (Moved) {
+      SE.forgetLoop(L0);
+      SE.forgetLoop(L1);
+   }
+
+   if (*Peel) {
+      Moved = true;
+      if (!peelIterations(L0, *Peel, DT, PDT, DTU, LI, SE))
+         return Missed("NotPeeled", "l'uscita delle iterazioni staccate non può essere unita a quella del loop");
+   }
+
+   if (!isReadyForFusion(L0, L1, SE))
+      return Missed("NotReady", "dopo lo spostamento del codice i due loop non sono adiacenti o non eseguono lo stesso numero di iterazioni");
+
+   ORE.emit([&]() {
+      return OptimizationRemark(DEBUG_TYPE, "Fused", L0->getStartLoc(), L0->getHeader())
+         << "loop fuso con il successivo: " << ore::NV("ReusedBytes", Reused) << " byte riusati per iterazione contro "
+         << ore::NV("SpilledBytes", Spilled) << " byte di registri salvati in memoria, "
+         << ore::NV("PeeledIterations", *Peel) << " iterazioni staccate";
+   });
+   return true;
+}
+
+// I loop fratelli vengono raggruppati in insiemi control flow equivalenti,
+// in ordine di programma: solo loop consecutivi dello stesso insieme possono
+// essere adiacenti. Al termine Siblings contiene i loop rimasti
+bool fuseSiblingLoops(SmallVector<Loop*> &Siblings, DominatorTree &DT, PostDominatorTree &PDT, DomTreeUpdater &DTU, LoopInfo &LI, ScalarEvolution &SE, DependenceInfo &DI, TargetTransformInfo &TTI, OptimizationRemarkEmitter &ORE) {
+   MapVector<BasicBlock*, SmallVector<Loop*>> CandidateSets;
+   SmallPtrSet<Loop*, 8> Fused;
+   // Riassunti degli accessi, calcolati alla prima richiesta
+   std::unordered_map<Loop*, AccessSummary> Summaries;
+   bool modified = false;
+
+   auto getSummary = [&](Loop *L) -> AccessSummary & {
+      auto It = Summaries.find(L);
+      if (It == Summaries.end())
+         It = Summaries.insert({L, summarizeAccesses(L, SE)}).first;
+      return It->second;
+   };
+
+   for (Loop *L : Siblings)
+      if (isFusionCandidate(L, SE))
+         CandidateSets[getCFEqRoot(getEntryBlock(L), DT, PDT)].push_back(L);
+
+   for (auto &Set : CandidateSets) {
+      SmallVector<Loop*> &Loops = Set.second;
+
+      // Il loop fuso resta candidato per la fusione con il loop successivo,
+      // così una catena di loop adiacenti diventa un unico loop
+      unsigned Idx = 0;
+      while (Idx + 1 < Loops.size()) {
+         Loop *L0 = Loops[Idx], *L1 = Loops[Idx + 1];
+
+         bool Moved = false;
+         bool Ready = prepareFusion(L0, L1, getSummary(L0), getSummary(L1), DT, PDT, DTU, LI, SE, DI, TTI, ORE, Moved);
+         modified |= Moved;
+
+         if (Ready) {
+            loopFusion(L0, L1, DTU, LI, SE);
+            modified = true;
+            // L1 è stato eliminato da LoopInfo, il riassunto di L0 viene
+            // ricalcolato con gli accessi di entrambi
+            Fused.insert(L1);
+            Summaries.erase(L0);
+            Summaries.erase(L1);
+            Loops.erase(Loops.begin() + Idx + 1);
+         } else
+            Idx++;
+      }
+   }
+
+   // I loop eliminati durante la fusione non vengono visitati nei livelli
+   // successivi
+   erase_if(Siblings, [&](Loop *L) { return Fused.count(L); });
+
+   return modified;
 }
 
 PreservedAnalyses MyLoopFusionPass::run(Function &F, FunctionAnalysisManager &AM) {
@@ -141,16 +826,39 @@ PreservedAnalyses MyLoopFusionPass::run(Function &F, FunctionAnalysisManager &AM
    PostDominatorTree &PDT = AM.getResult<PostDominatorTreeAnalysis>(F);
    LoopInfo &LI = AM.getResult<LoopAnalysis>(F);
    ScalarEvolution &SE = AM.getResult<ScalarEvolutionAnalysis>(F);
+   DependenceInfo &DI = AM.getResult<DependenceAnalysis>(F);
+   TargetTransformInfo &TTI = AM.getResult<TargetIRAnalysis>(F);
+   OptimizationRemarkEmitter &ORE = AM.getResult<OptimizationRemarkEmitterAnalysis>(F);
+   DomTreeUpdater DTU(DT, PDT, DomTreeUpdater::UpdateStrategy::Eager);
    bool modified = false;
 
-   for (Loop *L0 : LI)
-      for (Loop *L1 : LI)
-         if (L0 != L1)
-            if (isAdjacent(L0, L1) && isSameIterations(L0, L1, SE) && isCFEq(L0, L1, DT, PDT) && isNotNegDep(L0, L1)) {
-               loopFusion(L0, L1);
-               modified = true;
-            }
+   // La foresta dei loop viene visitata in preordine: i fratelli di ogni
+   // livello vengono fusi prima di scendere nei sottoloop, così anche i
+   // sottoloop dei loop appena fusi diventano fratelli e possono essere fusi.
+   // LoopInfo contiene i loop esterni in ordine inverso, i sottoloop in
+   // ordine di programma
+   SmallVector<SmallVector<Loop*>> Worklist;
+   Worklist.push_back(SmallVector<Loop*>(reverse(LI)));
+
+   while (!Worklist.empty()) {
+      SmallVector<Loop*> Siblings = Worklist.pop_back_val();
+
+      if (fuseSiblingLoops(Siblings, DT, PDT, DTU, LI, SE, DI, TTI, ORE))
+         modified = true;
+
+      for (Loop *L : Siblings)
+         if (!L->isInnermost())
+            Worklist.push_back(SmallVector<Loop*>(L->begin(), L->end()));
+   }
+
+   if (!modified) return PreservedAnalyses::all();
 
-   if (modified) return PreservedAnalyses::none();
-   return PreservedAnalyses::all();
+   // Dominatori, post-dominatori, LoopInfo e ScalarEvolution vengono
+   // aggiornati durante la fusione
+   PreservedAnalyses PA;
+   PA.preserve<DominatorTreeAnalysis>();
+   PA.preserve<PostDominatorTreeAnalysis>();
+   PA.preserve<LoopAnalysis>();
+   PA.preserve<ScalarEvolutionAnalysis>();
+   return PA;
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include <stdio.h>
+
+void foo(int *a, int n, int d) {
+  for (int i = 0; i < n; i++)
+    a[i] = (i - 4) / d;
+}
+
+int main() {
+  int a[8];
+
+  foo(a, 8, 3);
+  printf("%d,%d,%d,%d\n", a[0], a[3], a[5], a[7]);
+  return 0;
+}
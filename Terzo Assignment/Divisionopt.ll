@@ -0,0 +1,93 @@
+; ModuleID = '../TEST/Division.bc'
+source_filename = "../TEST/Division.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2) {
+  %4 = icmp eq i32 %2, 0
+  %5 = select i1 %4, i32 1, i32 %2
+  %6 = call i32 @llvm.abs.i32(i32 %5, i1 false)
+  %7 = sub i32 %6, 1
+  %8 = call i32 @llvm.ctlz.i32(i32 %7, i1 false)
+  %9 = sub i32 32, %8
+  %10 = zext i32 %6 to i64
+  %11 = zext i32 %9 to i64
+  %12 = shl i64 1, %11
+  %13 = sub i64 %12, %10
+  %14 = shl i64 %13, 32
+  %15 = udiv i64 %14, %10
+  %.magic = add i64 %15, 1
+  %.shift1 = call i32 @llvm.umin.i32(i32 %9, i32 1)
+  %.shift2 = call i32 @llvm.usub.sat.i32(i32 %9, i32 1)
+  br label %16
+
+16:                                               ; preds = %35, %3
+  %.0 = phi i32 [ 0, %3 ], [ %36, %35 ]
+  %17 = icmp slt i32 %.0, %1
+  br i1 %17, label %18, label %37
+
+18:                                               ; preds = %16
+  %19 = sub nsw i32 %.0, 4
+  %20 = xor i32 %19, %2
+  %21 = ashr i32 %20, 31
+  %22 = call i32 @llvm.abs.i32(i32 %19, i1 false)
+  %23 = zext i32 %22 to i64
+  %24 = mul i64 %.magic, %23
+  %25 = lshr i64 %24, 32
+  %26 = trunc i64 %25 to i32
+  %27 = sub i32 %22, %26
+  %28 = lshr i32 %27, %.shift1
+  %29 = add i32 %26, %28
+  %30 = lshr i32 %29, %.shift2
+  %31 = xor i32 %30, %21
+  %32 = sub i32 %31, %21
+  %33 = sext i32 %.0 to i64
+  %34 = getelementptr inbounds i32, ptr %0, i64 %33
+  store i32 %32, ptr %34, align 4
+  br label %35
+
+35:                                               ; preds = %18
+  %36 = add nsw i32 %.0, 1
+  br label %16
+
+37:                                               ; preds = %16
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [8 x i32], align 16
+  %2 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %2, i32 noundef 8, i32 noundef 3)
+  %3 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 0
+  %4 = load i32, ptr %3, align 16
+  %5 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 3
+  %6 = load i32, ptr %5, align 4
+  %7 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 5
+  %8 = load i32, ptr %7, align 4
+  %9 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 7
+  %10 = load i32, ptr %9, align 4
+  %11 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %4, i32 noundef %6, i32 noundef %8, i32 noundef %10)
+  ret i32 0
+}
+
+declare i32 @printf(ptr noundef, ...)
+
+declare i32 @llvm.abs.i32(i32, i1 immarg)
+
+declare i32 @llvm.ctlz.i32(i32, i1 immarg)
+
+declare i32 @llvm.umin.i32(i32, i32)
+
+declare i32 @llvm.usub.sat.i32(i32, i32)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+void foo(int *a, int n, int x, int d) {
+  for (int i = 0; i < n; i++)
+    a[i] = a[i] + x / d;
+}
+
+int main() {
+  int a[4] = {1, 2, 3, 4};
+
+  foo(a, 4, 12, 4);
+  foo(a, 0, 12, 0);
+  printf("%d,%d,%d,%d\n", a[0], a[1], a[2], a[3]);
+  return 0;
+}
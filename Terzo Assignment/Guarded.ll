@@ -0,0 +1,67 @@
+; ModuleID = '../TEST/Guarded.bc'
+source_filename = "../TEST/Guarded.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__const.main.a = private unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 16
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2, i32 noundef %3) {
+  br label %5
+
+5:                                                ; preds = %15, %4
+  %.0 = phi i32 [ 0, %4 ], [ %16, %15 ]
+  %6 = icmp slt i32 %.0, %1
+  br i1 %6, label %7, label %17
+
+7:                                                ; preds = %5
+  %8 = sext i32 %.0 to i64
+  %9 = getelementptr inbounds i32, ptr %0, i64 %8
+  %10 = load i32, ptr %9, align 4
+  %11 = sdiv i32 %2, %3
+  %12 = add nsw i32 %10, %11
+  %13 = sext i32 %.0 to i64
+  %14 = getelementptr inbounds i32, ptr %0, i64 %13
+  store i32 %12, ptr %14, align 4
+  br label %15
+
+15:                                               ; preds = %7
+  %16 = add nsw i32 %.0, 1
+  br label %5
+
+17:                                               ; preds = %5
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [4 x i32], align 16
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 16, i1 false)
+  %2 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %2, i32 noundef 4, i32 noundef 12, i32 noundef 4)
+  %3 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %3, i32 noundef 0, i32 noundef 12, i32 noundef 0)
+  %4 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  %5 = load i32, ptr %4, align 16
+  %6 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 1
+  %7 = load i32, ptr %6, align 4
+  %8 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 2
+  %9 = load i32, ptr %8, align 8
+  %10 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 3
+  %11 = load i32, ptr %10, align 4
+  %12 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %5, i32 noundef %7, i32 noundef %9, i32 noundef %11)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
@@ -8,8 +8,8 @@ target triple = "x86_64-unknown-linux-gnu"
 define dso_local void @foo(i32 noundef %0, i32 noundef %1) {
   %3 = add nsw i32 %0, 3
   %4 = add nsw i32 %0, 7
-  %5 = add nsw i32 %0, 4
-  %6 = add nsw i32 %0, 3
+  %5 = add nsw i32 %0, 3
+  %6 = add nsw i32 %0, 4
   %7 = add nsw i32 %3, 7
   %8 = add nsw i32 %4, 5
   br label %9
@@ -35,7 +35,7 @@ define dso_local void @foo(i32 noundef %0, i32 noundef %1) {
 
 17:                                               ; preds = %14
   %.lcssa4 = phi i32 [ %15, %14 ]
-  %.lcssa3 = phi i32 [ %5, %14 ]
+  %.lcssa3 = phi i32 [ %6, %14 ]
   %.05.lcssa = phi i32 [ %.05, %14 ]
   %.04.lcssa = phi i32 [ %.04, %14 ]
   %.03.lcssa = phi i32 [ %.03, %14 ]
@@ -48,7 +48,7 @@ define dso_local void @foo(i32 noundef %0, i32 noundef %1) {
   br label %19
 
 19:                                               ; preds = %18, %12
-  %.02 = phi i32 [ %6, %12 ], [ %5, %18 ]
+  %.02 = phi i32 [ %5, %12 ], [ %6, %18 ]
   %.1 = phi i32 [ %13, %12 ], [ %15, %18 ]
   %20 = add nsw i32 %.02, 2
   br label %9
@@ -1,19 +1,82 @@
 #include "llvm/Transforms/Utils/LoopICM.h"
+#include "llvm/Transforms/Utils/LocalOpts.h"
 #include "llvm/IR/Dominators.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/CodeMetrics.h"
+#include "llvm/Analysis/ConstantFolding.h"
+#include "llvm/Analysis/LoopAccessAnalysis.h"
+#include "llvm/Analysis/LoopIterator.h"
+#include "llvm/Analysis/MemorySSA.h"
+#include "llvm/Analysis/MemorySSAUpdater.h"
+#include "llvm/Analysis/MustExecute.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/LoopSimplify.h"
+#include "llvm/Transforms/Utils/LoopUtils.h"
+#include "llvm/Transforms/Utils/LoopVersioning.h"
+#include "llvm/Transforms/Utils/ScalarEvolutionExpander.h"
+#include "llvm/Transforms/Utils/SSAUpdater.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace llvm;
 
+static cl::opt<unsigned> SpeculationThreshold(
+   "loop-icm-speculation-threshold", cl::init(2), cl::Hidden,
+   cl::desc("Costo massimo di un'istruzione eseguita speculativamente nel preheader"));
+
+static cl::opt<unsigned> UnswitchThreshold(
+   "loop-icm-unswitch-threshold", cl::init(100), cl::Hidden,
+   cl::desc("Numero massimo di istruzioni del loop duplicato dall'unswitching"));
+
+static cl::opt<unsigned> UnswitchBudget(
+   "loop-icm-unswitch-budget", cl::init(400), cl::Hidden,
+   cl::desc("Numero massimo di istruzioni di tutte le copie prodotte dall'unswitching di un loop"));
+
+static cl::opt<unsigned> UnswitchMinExecutions(
+   "loop-icm-unswitch-min-executions", cl::init(2), cl::Hidden,
+   cl::desc("Esecuzioni minime del branch per ogni ingresso nel loop perché l'unswitching sia conveniente"));
+
+static cl::opt<unsigned> GuardExpansionBudget(
+   "loop-icm-guard-expansion-budget", cl::init(4), cl::Hidden,
+   cl::desc("Costo massimo del calcolo del numero di iterazioni per la guardia"));
+
+static cl::opt<bool> EnableMagicDivision(
+   "loop-icm-magic-division", cl::init(true), cl::Hidden,
+   cl::desc("Sostituisce le divisioni per un valore invariante con moltiplicazione e shift"));
+
+static cl::opt<unsigned> VersioningMaxChecks(
+   "loop-icm-versioning-max-checks", cl::init(8), cl::Hidden,
+   cl::desc("Numero massimo di controlli di alias a runtime per il versioning del loop"));
+
 std::unordered_set<Instruction*> loopInvariantInstructionSet{};
 std::vector<Instruction*> loopInvariantInstructionVector{};
 
 SmallVector<BasicBlock*> exitBlocks{};
-std::unordered_set<BasicBlock*> outBlocks{}; // successori fuori dal loop
+std::unordered_set<BasicBlock*> outBlocks{}; // successori fuori dal loop (blocchi di uscita)
+DomTreeNode *outBlocksDominator = nullptr;   // dominatore comune di outBlocks
 
 std::unordered_set<Instruction*> InstructionsToDelete{};
 
+std::unordered_map<Instruction*, BasicBlock*> hoistDestinations{}; // preheader in cui viene spostata ogni istruzione
+
+std::vector<Instruction*> guardedInstructions{}; // istruzioni che possono generare trap, spostate sotto guardia
+
 void printStats(Loop &L) {
    outs() << "The loop '" << L.getName() << "' is ";
 
@@ -37,9 +100,12 @@ bool isLoopInvariantOperand(Use &O, Loop &L) {
 
    Instruction *op = dyn_cast<Instruction>(O);
 
+   // Anche i PHI dei loop esterni (ad esempio le loro induction variable)
+   // sono invarianti rispetto al loop
+   if (op && !L.contains(op)) return true;
+
    if (op && op -> getOpcode() != Instruction::PHI) {
       if (loopInvariantInstructionSet.count(op))   return true;
-      if (!L.contains(op)) return true;
    }
 
    return false;
@@ -54,20 +120,88 @@ bool isLoopInvariantInstruction(Instruction &I, Loop &L) {
    return true;
 }
 
-bool isDeadInstruction(Instruction *I) {
-   for (Value *U : I -> users())
-      if (is_contained(outBlocks, dyn_cast<Instruction>(U) -> getParent()))  return false;
+// Load e call che leggono al più la memoria: sono invarianti se nessuna
+// istruzione del loop può scrivere la memoria da cui leggono
+bool isMemoryCandidate(Instruction &I, AAResults &AA) {
+   if (LoadInst *Load = dyn_cast<LoadInst>(&I))
+      return Load -> isUnordered();
 
-   return true;
+   CallInst *Call = dyn_cast<CallInst>(&I);
+
+   if (!Call || isa<DbgInfoIntrinsic>(Call) || Call -> getType() -> isVoidTy())   return false;
+   if (Call -> mayHaveSideEffects() || Call -> isConvergent())   return false;
+
+   return AA.onlyReadsMemory(Call);
 }
 
-bool codeMotionCheck(Instruction *I, DominatorTree &DT) {
-   if (isDeadInstruction(I))  return true;
+bool isClobberedInLoop(Instruction &I, Loop &L, AAResults &AA, MemorySSA *MSSA) {
+   CallInst *Call = dyn_cast<CallInst>(&I);
 
-   for (BasicBlock *BB : outBlocks)
-      if (!DT.dominates(I, BB))  return false;
+   if (Call && AA.doesNotAccessMemory(Call))  return false;
 
-   return true;
+   if (MSSA) {
+      MemoryUseOrDef *Access = MSSA -> getMemoryAccess(&I);
+      if (!Access)   return true;
+
+      MemoryAccess *Clobber = MSSA -> getWalker() -> getClobberingMemoryAccess(Access);
+
+      return !MSSA -> isLiveOnEntryDef(Clobber) && L.contains(Clobber -> getBlock());
+   }
+
+   // Senza MemorySSA si interroga l'alias analysis su ogni scrittura del loop
+   for (BasicBlock *BB : L.blocks())
+      for (Instruction &W : *BB) {
+         if (!W.mayWriteToMemory())  continue;
+
+         ModRefInfo MRI = Call ? AA.getModRefInfo(&W, Call) : AA.getModRefInfo(&W, MemoryLocation::get(&I));
+         if (isModSet(MRI))  return true;
+      }
+
+   return false;
+}
+
+bool isInvariantMemoryInstruction(Instruction &I, Loop &L, AAResults &AA, MemorySSA *MSSA) {
+   return isMemoryCandidate(I, AA) && isLoopInvariantInstruction(I, L) && !isClobberedInLoop(I, L, AA, MSSA);
+}
+
+// Una load o una call non possono essere spostate se nel preheader
+// verrebbero eseguite quando nel loop non lo sarebbero state
+bool memoryMotionCheck(Instruction *I, Loop &L, DominatorTree &DT, ICFLoopSafetyInfo &SafetyInfo) {
+   return isSafeToSpeculativelyExecute(I) || SafetyInfo.isGuaranteedToExecute(*I, &DT, &L);
+}
+
+// Un blocco domina tutti i blocchi di outBlocks se e solo se domina il loro
+// dominatore comune: con la numerazione DFS dell'albero il controllo
+// richiede tempo costante
+bool dominatesOutBlocks(Instruction *I, DominatorTree &DT) {
+   if (!outBlocksDominator)   return true;
+
+   DomTreeNode *N = DT.getNode(I -> getParent());
+
+   return N -> getDFSNumIn() <= outBlocksDominator -> getDFSNumIn() && outBlocksDominator -> getDFSNumOut() <= N -> getDFSNumOut();
+}
+
+// Un'istruzione che non domina le uscite viene eseguita speculativamente
+// nel preheader: non deve poter generare trap e deve costare poco
+bool isSpeculationProfitable(Instruction *I, TargetTransformInfo &TTI) {
+   if (!isSafeToSpeculativelyExecute(I))  return false;
+
+   InstructionCost Cost = TTI.getInstructionCost(I, TargetTransformInfo::TCK_SizeAndLatency);
+
+   return Cost.isValid() && Cost <= SpeculationThreshold;
+}
+
+// In forma LCSSA gli user fuori dal loop sono PHI dei blocchi di uscita:
+// un'istruzione il cui valore è usato dopo il loop domina i predecessori di
+// quei PHI, quindi non serve distinguere le variabili dead all'uscita e ogni
+// istruzione che non domina le uscite viene eseguita speculativamente
+bool codeMotionCheck(Instruction *I, Loop &L, DominatorTree &DT, TargetTransformInfo &TTI, ICFLoopSafetyInfo &SafetyInfo) {
+   if (!dominatesOutBlocks(I, DT))  return isSpeculationProfitable(I, TTI);
+
+   // Un'istruzione che può generare trap viene spostata senza guardia solo
+   // se è sicuramente eseguita ad ogni ingresso nel loop (le istruzioni
+   // dell'header, o del corpo di un loop ruotato)
+   return isSafeToSpeculativelyExecute(I) || SafetyInfo.isGuaranteedToExecute(*I, &DT, &L);
 }
 
 void printInfo() {
@@ -82,56 +216,1254 @@ void printInfo() {
       outs() << *inst << "\n";
 }
 
-void setOutBlocks() {
+void setOutBlocks(DominatorTree &DT) {
+   // I blocchi di uscita sono già i successori fuori dal loop
    for (BasicBlock *exitBlock : exitBlocks) 
-      for (BasicBlock *successor : successors(exitBlock))
-         outBlocks.insert(successor);
+      outBlocks.insert(exitBlock);
+
+   // Calcolato una sola volta per loop
+   BasicBlock *NCD = nullptr;
+
+   for (BasicBlock *BB : outBlocks)
+      NCD = NCD ? DT.findNearestCommonDominator(NCD, BB) : BB;
+
+   DT.updateDFSNumbers();
+   outBlocksDominator = NCD ? DT.getNode(NCD) : nullptr;
+}
+
+void resetState() {
+   loopInvariantInstructionSet.clear();
+   loopInvariantInstructionVector.clear();
+   exitBlocks.clear();
+   outBlocks.clear();
+   outBlocksDominator = nullptr;
+   InstructionsToDelete.clear();
+   hoistDestinations.clear();
+   guardedInstructions.clear();
+}
+
+// Istruzioni senza effetti collaterali, il cui valore dipende solo dagli
+// operandi: operazioni aritmetiche, conversioni, calcolo di indirizzi,
+// confronti, select e intrinsic pure (llvm.fabs, llvm.umin, ...)
+bool isPureCandidate(Instruction &I) {
+   if (I.getType() -> isTokenTy())  return false;
+
+   if (I.isBinaryOp() || I.isUnaryOp() || I.isCast())  return true;
+
+   if (isa<GetElementPtrInst>(I) || isa<CmpInst>(I) || isa<SelectInst>(I) || isa<FreezeInst>(I))  return true;
+
+   if (isa<ExtractElementInst>(I) || isa<InsertElementInst>(I) || isa<ShuffleVectorInst>(I))  return true;
+
+   if (isa<ExtractValueInst>(I) || isa<InsertValueInst>(I))  return true;
+
+   if (IntrinsicInst *II = dyn_cast<IntrinsicInst>(&I))
+      return II -> doesNotAccessMemory() && !II -> mayHaveSideEffects() && !II -> isConvergent() && isSafeToSpeculativelyExecute(II);
+
+   return false;
+}
+
+bool isHoistCandidate(Instruction &I, AAResults &AA) {
+   return isPureCandidate(I) || isMemoryCandidate(I, AA);
+}
+
+// Un'istruzione che può generare trap può essere spostata sotto guardia se
+// viene eseguita ad ogni iterazione completa: l'header è l'unico blocco di
+// uscita, il suo blocco domina il latch e nessuna istruzione del loop può
+// interrompere l'esecuzione. Viene quindi eseguita almeno una volta se e
+// solo se il loop esegue almeno un'iterazione. Le istruzioni dell'header
+// vengono eseguite anche quando il corpo non lo è, ma sono sicuramente
+// eseguite e vengono già spostate senza guardia
+bool canHoistGuarded(Instruction &I, Loop &L, DominatorTree &DT, ICFLoopSafetyInfo &SafetyInfo) {
+   if (L.getExitingBlock() != L.getHeader() || !L.getLoopLatch())  return false;
+   if (I.getParent() == L.getHeader() || SafetyInfo.anyBlockMayThrow())  return false;
+
+   return DT.dominates(I.getParent(), L.getLoopLatch());
+}
+
+// Classifica un'istruzione i cui operandi nel loop sono già tutti invarianti;
+// restituisce true se viene spostata, e quindi rende invarianti i suoi user
+bool classifyInstruction(Instruction &I, Loop &L, DominatorTree &DT, TargetTransformInfo &TTI, AAResults &AA, MemorySSA *MSSA, ICFLoopSafetyInfo &SafetyInfo, bool Guarded) {
+   if (isPureCandidate(I) && isLoopInvariantInstruction(I, L)) {     
+      // Se l'istruzione non viene usata, la elimino
+      if (std::distance(I.user_begin(), I.user_end()) == 0) {
+         InstructionsToDelete.insert(&I);          
+         return false;
+      }    
+      
+      // Se l'istruzione è loop invariant e movable, la si salva
+      if (codeMotionCheck(&I, L, DT, TTI, SafetyInfo)) {
+         loopInvariantInstructionSet.insert(&I);
+         loopInvariantInstructionVector.push_back(&I);
+         return true;
+      }
+
+      // Gli user restano nel loop: l'istruzione viene spostata solo dopo gli
+      // altri invarianti
+      if (Guarded && canHoistGuarded(I, L, DT, SafetyInfo))
+         guardedInstructions.push_back(&I);
+   } else if (isInvariantMemoryInstruction(I, L, AA, MSSA)) {
+      if (std::distance(I.user_begin(), I.user_end()) == 0) {
+         InstructionsToDelete.insert(&I);
+         return false;
+      }
+
+      if (memoryMotionCheck(&I, L, DT, SafetyInfo)) {
+         loopInvariantInstructionSet.insert(&I);
+         loopInvariantInstructionVector.push_back(&I);
+         return true;
+      }
+
+      if (Guarded && canHoistGuarded(I, L, DT, SafetyInfo))
+         guardedInstructions.push_back(&I);
+   }
+
+   return false;
+}
+
+// Operazioni associative e commutative su interi che possono essere
+// raggruppate diversamente
+bool isReassociable(Instruction &I) {
+   if (!I.getType() -> isIntOrIntVectorTy())  return false;
+
+   switch (I.getOpcode()) {
+      case Instruction::Add:
+      case Instruction::Mul:
+      case Instruction::And:
+      case Instruction::Or:
+      case Instruction::Xor:
+         return true;
+      default:
+         return false;
+   }
+}
+
+// (X op A) op B, con A e B invarianti e X variante, diventa X op (A op B):
+// A op B è invariante e viene calcolata direttamente nel preheader.
+// La somma interna deve avere un solo user, altrimenti resterebbe nel loop
+bool reassociateInstruction(Instruction &I, Loop &L, ScalarEvolution &SE) {
+   if (!isReassociable(I)) return false;
+
+   for (unsigned Idx = 0; Idx < 2; Idx++) {
+      BinaryOperator *Inner = dyn_cast<BinaryOperator>(I.getOperand(Idx));
+      Value *B = I.getOperand(1 - Idx);
+
+      if (!Inner || Inner -> getOpcode() != I.getOpcode() || !Inner -> hasOneUse() || !L.contains(Inner))  continue;
+      if (!L.isLoopInvariant(B)) continue;
+
+      Value *X = Inner -> getOperand(0), *A = Inner -> getOperand(1);
+      if (!L.isLoopInvariant(A))  std::swap(X, A);
+      if (!L.isLoopInvariant(A) || L.isLoopInvariant(X))  continue;
+
+      const DataLayout &DL = I.getModule() -> getDataLayout();
+      BasicBlock *Preheader = L.getLoopPreheader();
+
+      // Senza overflow unsigned in nessuna delle due somme, anche A + B e
+      // X + (A + B) non vanno in overflow; gli altri flag vengono rimossi
+      bool NUW = I.getOpcode() == Instruction::Add && I.hasNoUnsignedWrap() && Inner -> hasNoUnsignedWrap();
+
+      Value *Invariant = nullptr;
+      if (isa<Constant>(A) && isa<Constant>(B))
+         Invariant = ConstantFoldBinaryOpOperands(I.getOpcode(), cast<Constant>(A), cast<Constant>(B), DL);
+
+      if (!Invariant) {
+         BinaryOperator *NewInst = BinaryOperator::Create(Inner -> getOpcode(), A, B, I.getName() + ".reass", Preheader -> getTerminator());
+         if (NUW) NewInst -> setHasNoUnsignedWrap(true);
+         Invariant = NewInst;
+      }
+
+      SE.forgetValue(&I);
+
+      I.setOperand(0, X);
+      I.setOperand(1, Invariant);
+      I.dropPoisonGeneratingFlags();
+      if (NUW) I.setHasNoUnsignedWrap(true);
+
+      Inner -> eraseFromParent();
+      return true;
+   }
+
+   return false;
+}
+
+// Le catene vengono visitate in ordine di dominanza, quindi
+// ((X + A) + B) + C diventa X + ((A + B) + C)
+bool reassociateInvariants(Loop &L, DominatorTree &DT, ScalarEvolution &SE) {
+   bool changed = false;
+
+   for (DomTreeNode *N : collectChildrenInLoop(DT.getNode(L.getHeader()), &L))
+      for (Instruction &I : *N -> getBlock())
+         if (reassociateInstruction(I, L, SE))  changed = true;
+
+   return changed;
+}
+
+// Le istruzioni vengono visitate seguendo l'albero di dominanza: ognuna
+// conta i propri operandi definiti nel loop ed entra nella worklist solo
+// quando sono diventati tutti invarianti, così le catene di invarianti
+// vengono trovate in un'unica passata lineare nel numero di istruzioni
+void findLoopInvariants(Loop &L, DominatorTree &DT, TargetTransformInfo &TTI, AAResults &AA, MemorySSA *MSSA, ICFLoopSafetyInfo &SafetyInfo, bool Guarded) {
+   DenseMap<Instruction*, unsigned> PendingOperands{};
+   SmallVector<Instruction*> Worklist{};
+
+   for (DomTreeNode *N : collectChildrenInLoop(DT.getNode(L.getHeader()), &L))
+      for (Instruction &I : *N -> getBlock()) {
+         if (!isHoistCandidate(I, AA))  continue;
+
+         unsigned Pending = 0;
+         for (Use &O : I.operands())
+            if (Instruction *op = dyn_cast<Instruction>(O))
+               if (L.contains(op))  Pending++;
+
+         if (Pending == 0) Worklist.push_back(&I);
+         else  PendingOperands[&I] = Pending;
+      }
+
+   for (unsigned Idx = 0; Idx < Worklist.size(); Idx++) {
+      Instruction *I = Worklist[Idx];
+
+      if (!classifyInstruction(*I, L, DT, TTI, AA, MSSA, SafetyInfo, Guarded))  continue;
+
+      for (User *U : I -> users()) {
+         auto It = PendingOperands.find(dyn_cast<Instruction>(U));
+         if (It != PendingOperands.end() && --It -> second == 0)
+            Worklist.push_back(It -> first);
+      }
+   }
+}
+
+// Un'istruzione già invariante nel loop L lo è anche nel loop esterno Outer
+// se i suoi operandi vengono calcolati fuori da Outer; dato che nel
+// preheader di Outer verrebbe eseguita anche quando L non viene raggiunto,
+// deve essere sicura da eseguire speculativamente
+bool isInvariantInOuterLoop(Instruction *I, Loop *Outer, AAResults &AA, MemorySSA *MSSA) {
+   for (Use &O : I -> operands()) {
+      Instruction *op = dyn_cast<Instruction>(O);
+      if (!op) continue;
+
+      auto It = hoistDestinations.find(op);
+      BasicBlock *OpBlock = It != hoistDestinations.end() ? It -> second : op -> getParent();
+
+      if (Outer -> contains(OpBlock))  return false;
+   }
+
+   if (!isSafeToSpeculativelyExecute(I))  return false;
+
+   if (I -> mayReadFromMemory() && isClobberedInLoop(*I, *Outer, AA, MSSA))  return false;
+
+   return true;
+}
+
+// Preheader del loop più esterno del nest rispetto al quale l'istruzione è
+// invariante
+BasicBlock *getHoistDestination(Instruction *I, Loop &L, AAResults &AA, MemorySSA *MSSA) {
+   Loop *Target = &L;
+
+   for (Loop *Outer = L.getParentLoop(); Outer; Outer = Outer -> getParentLoop()) {
+      if (!Outer -> getLoopPreheader() || !isInvariantInOuterLoop(I, Outer, AA, MSSA))  break;
+
+      Target = Outer;
+   }
+
+   return Target -> getLoopPreheader();
+}
+
+unsigned getRegisterClass(Value *V, TargetTransformInfo &TTI) {
+   return TTI.getRegisterClassForType(V -> getType() -> isVectorTy(), V -> getType());
+}
+
+// Un valore occupa un registro per tutto il loop se è un PHI dell'header o
+// se è definito fuori dal loop (o spostato nel preheader) e usato da
+// un'istruzione che resta nel loop
+bool isLiveAcrossLoop(Value *V, Loop &L) {
+   if (V -> getType() -> isVoidTy() || V -> getType() -> isTokenTy() || V -> getType() -> isLabelTy())  return false;
+   if (isa<Argument>(V))   return true;
+
+   Instruction *I = dyn_cast<Instruction>(V);
+   if (!I)  return false;
+
+   return !L.contains(I) || loopInvariantInstructionSet.count(I);
+}
+
+// Stima della pressione sui registri dopo lo spostamento delle istruzioni
+// invarianti: numero di valori vivi per tutto il loop, per classe
+void computeLoopPressure(Loop &L, TargetTransformInfo &TTI, DenseMap<unsigned, unsigned> &Pressure) {
+   SmallPtrSet<Value*, 32> Live{};
+
+   for (PHINode &PN : L.getHeader() -> phis())
+      Live.insert(&PN);
+
+   for (BasicBlock *BB : L.blocks())
+      for (Instruction &I : *BB) {
+         if (loopInvariantInstructionSet.count(&I))  continue;
+
+         for (Use &O : I.operands())
+            if (isLiveAcrossLoop(O, L))   Live.insert(O);
+      }
+
+   for (Value *V : Live)
+      Pressure[getRegisterClass(V, TTI)]++;
+}
+
+// Istruzioni economiche da ricalcolare ad ogni iterazione (ad esempio la
+// somma con una costante): se restano nel loop liberano il loro registro
+// senza allungare la vita del loro operando, che è già vivo
+bool isRematerializable(Instruction *I, Loop &L, TargetTransformInfo &TTI) {
+   if (!I -> isBinaryOp())  return false;
+
+   Value *Op0 = I -> getOperand(0), *Op1 = I -> getOperand(1);
+   Value *Other = isa<Constant>(Op1) ? Op0 : isa<Constant>(Op0) ? Op1 : nullptr;
+   if (!Other) return false;
+
+   if (!isa<Constant>(Other)) {
+      bool OtherIsLive = false;
+
+      for (User *U : Other -> users()) {
+         Instruction *UI = dyn_cast<Instruction>(U);
+         if (UI && UI != I && L.contains(UI) && !loopInvariantInstructionSet.count(UI))   OtherIsLive = true;
+      }
+
+      if (!OtherIsLive || !isLiveAcrossLoop(Other, L))  return false;
+   }
+
+   InstructionCost Cost = TTI.getInstructionCost(I, TargetTransformInfo::TCK_SizeAndLatency);
+
+   return Cost.isValid() && Cost <= TargetTransformInfo::TCC_Basic;
+}
+
+// Se i valori vivi superano i registri disponibili, le istruzioni
+// rimaterializzabili vengono lasciate nel loop, partendo dalle ultime
+// individuate; sono escluse quelle da cui dipendono altre istruzioni spostate
+void limitRegisterPressure(Loop &L, TargetTransformInfo &TTI) {
+   while (true) {
+      DenseMap<unsigned, unsigned> Pressure{};
+      computeLoopPressure(L, TTI, Pressure);
+
+      auto Victim = loopInvariantInstructionVector.rend();
+
+      for (auto It = loopInvariantInstructionVector.rbegin(); It != loopInvariantInstructionVector.rend(); It++) {
+         Instruction *I = *It;
+         unsigned ClassID = getRegisterClass(I, TTI);
+
+         if (Pressure[ClassID] <= TTI.getNumberOfRegisters(ClassID)) continue;
+
+         bool IsLeaf = none_of(I -> users(), [](User *U) {
+            return loopInvariantInstructionSet.count(dyn_cast<Instruction>(U)) > 0;
+         });
+         bool UsedInLoop = any_of(I -> users(), [&L](User *U) {
+            return L.contains(cast<Instruction>(U));
+         });
+
+         if (IsLeaf && UsedInLoop && isRematerializable(I, L, TTI)) {
+            Victim = It;
+            break;
+         }
+      }
+
+      if (Victim == loopInvariantInstructionVector.rend())  return;
+
+      loopInvariantInstructionSet.erase(*Victim);
+      loopInvariantInstructionVector.erase(std::next(Victim).base());
+   }
+}
+
+// Con la frequenza dei blocchi, lo spostamento conviene solo se il
+// preheader non viene eseguito più spesso del blocco dell'istruzione
+// (ad esempio un ramo raro di un loop con poche iterazioni)
+bool isHoistProfitable(Instruction *I, BasicBlock *Preheader, BlockFrequencyInfo *BFI) {
+   if (!BFI)   return true;
+
+   uint64_t PreheaderFreq = BFI -> getBlockFreq(Preheader).getFrequency();
+   uint64_t BlockFreq = BFI -> getBlockFreq(I -> getParent()).getFrequency();
+
+   // Blocchi creati dopo il calcolo della BFI
+   if (PreheaderFreq == 0 || BlockFreq == 0)   return true;
+
+   return PreheaderFreq <= BlockFreq;
+}
+
+// Un'istruzione che resta nel loop viene spostata nel blocco più freddo che
+// domina tutti i suoi user, senza entrare in sottoloop. Senza BFI non è
+// possibile stabilire quale blocco sia più freddo
+void sinkToColdBlock(Instruction *I, Loop &L, DominatorTree &DT, LoopInfo &LI, BlockFrequencyInfo *BFI) {
+   if (!BFI)   return;
+   if (I -> mayReadOrWriteMemory() || I -> use_empty())   return;
+
+   BasicBlock *Target = nullptr;
+
+   for (Use &U : I -> uses()) {
+      Instruction *UI = cast<Instruction>(U.getUser());
+      BasicBlock *UseBlock = UI -> getParent();
+
+      if (PHINode *PN = dyn_cast<PHINode>(UI))  UseBlock = PN -> getIncomingBlock(U);
+      if (!L.contains(UseBlock)) return;
+
+      Target = Target ? DT.findNearestCommonDominator(Target, UseBlock) : UseBlock;
+   }
+
+   if (!Target || Target == I -> getParent() || LI.getLoopFor(Target) != LI.getLoopFor(I -> getParent()))  return;
+   if (BFI -> getBlockFreq(Target).getFrequency() >= BFI -> getBlockFreq(I -> getParent()).getFrequency())   return;
+
+   // Prima del primo user nel blocco, altrimenti all'inizio del blocco
+   Instruction *InsertPt = &*Target -> getFirstInsertionPt();
+   for (Instruction &Candidate : *Target) {
+      if (isa<PHINode>(Candidate))  continue;
+
+      if (is_contained(I -> users(), &Candidate)) {
+         InsertPt = &Candidate;
+         break;
+      }
+   }
+
+   I -> moveBefore(InsertPt);
 }
 
 // Eventuali rimozioni o spostamenti
-void action(Loop &L) {
-   for (Instruction *inst : InstructionsToDelete) 
+void action(Loop &L, DominatorTree &DT, LoopInfo &LI, AAResults &AA, MemorySSA *MSSA, MemorySSAUpdater *MSSAU, BlockFrequencyInfo *BFI) {
+   for (Instruction *inst : InstructionsToDelete) {
+      if (MSSAU)  MSSAU -> removeMemoryAccess(inst);
       inst -> eraseFromParent();
+   }
+
+   // Istruzioni lasciate nel loop perché lo spostamento non conviene:
+   // anche le istruzioni che le usano restano nel loop
+   std::unordered_set<Instruction*> Kept{};
+   std::vector<Instruction*> KeptOrder{};
+
+   // Le istruzioni vengono spostate nell'ordine in cui sono state individuate,
+   // quindi la destinazione dei loro operandi è già nota
+   for (Instruction *I : loopInvariantInstructionVector) {
+      bool OperandKept = any_of(I -> operands(), [&Kept](Use &O) {
+         return Kept.count(dyn_cast<Instruction>(O)) > 0;
+      });
+
+      BasicBlock *Preheader = OperandKept ? nullptr : getHoistDestination(I, L, AA, MSSA);
+
+      // Se il preheader del loop più esterno è troppo caldo si prova con
+      // quello del loop corrente
+      if (Preheader && !isHoistProfitable(I, Preheader, BFI))
+         Preheader = isHoistProfitable(I, L.getLoopPreheader(), BFI) ? L.getLoopPreheader() : nullptr;
+
+      if (!Preheader) {
+         Kept.insert(I);
+         KeptOrder.push_back(I);
+         continue;
+      }
+
+      hoistDestinations[I] = Preheader;
+
+      I -> moveBefore(Preheader -> getTerminator());
+
+      // Le load e le call spostate devono essere spostate anche in MemorySSA
+      if (MSSAU)
+         if (MemoryUseOrDef *Access = MSSAU -> getMemorySSA() -> getMemoryAccess(I))
+            MSSAU -> moveToPlace(Access, Preheader, MemorySSA::BeforeTerminator);
+   }
+
+   // Dagli user verso gli operandi, così gli operandi seguono i loro user
+   for (auto It = KeptOrder.rbegin(); It != KeptOrder.rend(); It++) {
+      loopInvariantInstructionSet.erase(*It);
+      sinkToColdBlock(*It, L, DT, LI, BFI);
+   }
+}
+
+// Le istruzioni che possono generare trap vengono spostate in un blocco
+// eseguito solo se il loop esegue almeno un'iterazione, cioè se il numero
+// di iterazioni calcolato da SCEV (backedge-taken count) è diverso da zero.
+// Nel nuovo preheader un PHI unisce il valore calcolato e poison, che non
+// viene mai usato perché in quel caso il corpo del loop non viene eseguito.
+// getLoopGuardBranch non può essere riusata: riconosce solo il branch già
+// presente prima di un loop ruotato, che decide se viene eseguito l'header,
+// mentre qui il loop non è ruotato e la guardia riguarda il corpo
+bool hoistGuardedInstructions(Loop &L, DominatorTree &DT, LoopInfo &LI, ScalarEvolution &SE, TargetTransformInfo &TTI, MemorySSAUpdater *MSSAU) {
+   // Gli operandi devono essere già stati spostati fuori dal loop
+   SmallVector<Instruction*> ToHoist{};
+   for (Instruction *I : guardedInstructions)
+      if (L.hasLoopInvariantOperands(I)) ToHoist.push_back(I);
+
+   if (ToHoist.empty()) return false;
+
+   const SCEV *BackedgeTakenCount = SE.getBackedgeTakenCount(&L);
+   if (isa<SCEVCouldNotCompute>(BackedgeTakenCount))  return false;
+
+   // Con un numero di iterazioni costante la guardia non serve
+   if (const SCEVConstant *Count = dyn_cast<SCEVConstant>(BackedgeTakenCount)) {
+      if (Count -> isZero())  return false;
+
+      BasicBlock *Preheader = L.getLoopPreheader();
+      for (Instruction *I : ToHoist) {
+         I -> moveBefore(Preheader -> getTerminator());
+
+         if (MSSAU)
+            if (MemoryUseOrDef *Access = MSSAU -> getMemorySSA() -> getMemoryAccess(I))
+               MSSAU -> moveToPlace(Access, Preheader, MemorySSA::BeforeTerminator);
+      }
+
+      return true;
+   }
+
+   const DataLayout &DL = L.getHeader() -> getModule() -> getDataLayout();
+   SCEVExpander Expander(SE, DL, "loop-icm");
+
+   // Il vecchio preheader calcola la condizione, il nuovo blocco di guardia
+   // contiene le istruzioni spostate
+   BasicBlock *Check = L.getLoopPreheader();
+   if (!Expander.isSafeToExpandAt(BackedgeTakenCount, Check -> getTerminator()))  return false;
+
+   // La guardia non deve costare più delle istruzioni che protegge
+   if (Expander.isHighCostExpansion(BackedgeTakenCount, &L, GuardExpansionBudget, &TTI, Check -> getTerminator()))  return false;
+   Value *Count = Expander.expandCodeFor(BackedgeTakenCount, BackedgeTakenCount -> getType(), Check -> getTerminator());
+   Value *Cond = new ICmpInst(Check -> getTerminator(), ICmpInst::ICMP_NE, Count, Constant::getNullValue(Count -> getType()), "licm.guard.cond");
+
+   BasicBlock *Preheader = SplitBlock(Check, Check -> getTerminator(), &DT, &LI, MSSAU);
+   BasicBlock *Guard = BasicBlock::Create(Check -> getContext(), "licm.guard", Check -> getParent(), Preheader);
+   BranchInst::Create(Preheader, Guard);
+
+   Check -> getTerminator() -> eraseFromParent();
+   BranchInst::Create(Guard, Preheader, Cond, Check);
+
+   if (Loop *Parent = L.getParentLoop())  Parent -> addBasicBlockToLoop(Guard, LI);
+   DT.addNewBlock(Guard, Check);
+
+   if (MSSAU)
+      MSSAU -> applyInsertUpdates({{DominatorTree::Insert, Check, Guard}, {DominatorTree::Insert, Guard, Preheader}}, DT);
+
+   // Prima vengono spostate tutte le istruzioni, poi gli user fuori dalla
+   // guardia vengono collegati ai PHI
+   for (Instruction *I : ToHoist) {
+      I -> moveBefore(Guard -> getTerminator());
+
+      if (MSSAU)
+         if (MemoryUseOrDef *Access = MSSAU -> getMemorySSA() -> getMemoryAccess(I))
+            MSSAU -> moveToPlace(Access, Guard, MemorySSA::BeforeTerminator);
+   }
+
+   for (Instruction *I : ToHoist) {
+      PHINode *PN = PHINode::Create(I -> getType(), 2, I -> getName() + ".guarded", &Preheader -> front());
+      PN -> addIncoming(I, Guard);
+      PN -> addIncoming(PoisonValue::get(I -> getType()), Check);
+
+      I -> replaceUsesWithIf(PN, [Guard, PN](Use &U) {
+         return U.getUser() != PN && cast<Instruction>(U.getUser()) -> getParent() != Guard;
+      });
+   }
+
+   SE.forgetLoop(&L);
+
+   return true;
+}
+
+// Numero stimato di esecuzioni di BB per ogni ingresso nel loop.
+// Senza BFI, o per blocchi creati dopo il suo calcolo, la stima non è
+// disponibile e viene restituito il valore massimo
+uint64_t getExecutionsPerEntry(BasicBlock *BB, Loop &L, BlockFrequencyInfo *BFI) {
+   if (!BFI)   return UINT64_MAX;
+
+   uint64_t PreheaderFreq = BFI -> getBlockFreq(L.getLoopPreheader()).getFrequency();
+   uint64_t BlockFreq = BFI -> getBlockFreq(BB).getFrequency();
+
+   if (PreheaderFreq == 0 || BlockFreq == 0)   return UINT64_MAX;
+
+   return BlockFreq / PreheaderFreq;
+}
+
+// Le divisioni per un valore invariante ma non costante vengono sostituite
+// da una moltiplicazione e due shift (LocalOpts); moltiplicatore e shift
+// vengono calcolati una sola volta nel preheader per ogni divisore
+bool replaceInvariantDivisions(Loop &L, ScalarEvolution &SE, BlockFrequencyInfo *BFI) {
+   if (!EnableMagicDivision)  return false;
+
+   BasicBlock *Preheader = L.getLoopPreheader();
+   std::map<std::pair<Value*, bool>, MagicDivisor> Divisors{};
+   SmallVector<BinaryOperator*> Divisions{};
+
+   for (BasicBlock *BB : L.blocks()) {
+      // Il calcolo nel preheader conviene solo se la divisione viene ripetuta
+      if (getExecutionsPerEntry(BB, L, BFI) < 2)   continue;
 
-   Instruction *T = L.getLoopPreheader() -> getTerminator();
+      for (Instruction &I : *BB) {
+         BinaryOperator *Div = dyn_cast<BinaryOperator>(&I);
 
-   for (Instruction *I : loopInvariantInstructionVector) 
-      I -> moveBefore(T);
+         if (!Div || !isMagicDivisionCandidate(Div))  continue;
+         if (!L.isLoopInvariant(Div -> getOperand(1)) || L.isLoopInvariant(Div -> getOperand(0)))  continue;
+
+         Divisions.push_back(Div);
+      }
+   }
+
+   for (BinaryOperator *Div : Divisions) {
+      bool Signed = Div -> getOpcode() == Instruction::SDiv || Div -> getOpcode() == Instruction::SRem;
+      auto Key = std::make_pair(Div -> getOperand(1), Signed);
+
+      auto It = Divisors.find(Key);
+      if (It == Divisors.end())
+         It = Divisors.emplace(Key, computeMagicDivisor(Div -> getOperand(1), Signed, Preheader -> getTerminator())).first;
+
+      Value *Result = expandMagicDivision(Div, It -> second);
+      Result -> takeName(Div);
+
+      SE.forgetValue(Div);
+      Div -> replaceAllUsesWith(Result);
+      Div -> eraseFromParent();
+   }
+
+   return !Divisions.empty();
+}
+
+// Un'istruzione calcolata ad ogni iterazione ma usata solo dopo il loop:
+// in forma LCSSA i suoi user sono PHI nei blocchi di uscita, che ricevono
+// l'istruzione da tutti i loro predecessori
+bool isUsedOnlyOutsideLoop(Instruction &I, Loop &L) {
+   if (I.use_empty())   return false;
+
+   for (User *U : I.users()) {
+      PHINode *PN = dyn_cast<PHINode>(U);
+      if (!PN || L.contains(PN)) return false;
+
+      for (Value *V : PN -> incoming_values())
+         if (V != &I)   return false;
+   }
+
+   return true;
+}
+
+bool isSinkCandidate(Instruction &I) {
+   if (isa<PHINode>(I) || isa<AllocaInst>(I) || isa<DbgInfoIntrinsic>(I) || I.isTerminator() || I.isEHPad())   return false;
+   if (I.getType() -> isTokenTy())  return false;
+
+   if (CallBase *Call = dyn_cast<CallBase>(&I))
+      if (Call -> isConvergent())   return false;
+
+   return !I.mayHaveSideEffects() && !I.mayReadFromMemory();
+}
+
+// PHI LCSSA per un valore del loop usato nel blocco di uscita Exit
+PHINode *getLCSSAPhi(Instruction *I, BasicBlock *Exit) {
+   for (PHINode &PN : Exit -> phis())
+      if (all_of(PN.incoming_values(), [I](Value *V) { return V == I; }))
+         return &PN;
+
+   PHINode *PN = PHINode::Create(I -> getType(), pred_size(Exit), I -> getName() + ".lcssa", &Exit -> front());
+   for (BasicBlock *Pred : predecessors(Exit))
+      PN -> addIncoming(I, Pred);
+
+   return PN;
+}
+
+// L'istruzione viene clonata in ogni blocco di uscita che la usa, così
+// viene eseguita una sola volta invece che ad ogni iterazione
+void sinkInstruction(Instruction &I, Loop &L) {
+   DenseMap<BasicBlock*, Instruction*> Clones{};
+   SmallVector<PHINode*> Users{};
+
+   for (User *U : I.users())
+      Users.push_back(cast<PHINode>(U));
+
+   for (PHINode *PN : Users) {
+      BasicBlock *Exit = PN -> getParent();
+      Instruction *&Clone = Clones[Exit];
+
+      if (!Clone) {
+         Clone = I.clone();
+         Clone -> setName(I.getName());
+         Clone -> insertBefore(&*Exit -> getFirstInsertionPt());
+
+         // Gli operandi definiti nel loop passano da PHI LCSSA
+         for (Use &Op : Clone -> operands())
+            if (Instruction *OpI = dyn_cast<Instruction>(Op))
+               if (L.contains(OpI))
+                  Op.set(getLCSSAPhi(OpI, Exit));
+      }
+
+      PN -> replaceAllUsesWith(Clone);
+      PN -> eraseFromParent();
+   }
+
+   I.eraseFromParent();
+}
+
+// Le istruzioni vengono visitate dal basso verso l'alto, così anche gli
+// operandi rimasti usati solo dai cloni possono essere spostati
+bool sinkLoopOutputs(Loop &L, DominatorTree &DT) {
+   if (!L.hasDedicatedExits())   return false;
+
+   SmallVector<DomTreeNode*, 16> Nodes = collectChildrenInLoop(DT.getNode(L.getHeader()), &L);
+   bool sunk = false;
+
+   for (DomTreeNode *N : reverse(Nodes))
+      for (Instruction &I : make_early_inc_range(reverse(*N -> getBlock())))
+         if (isSinkCandidate(I) && isUsedOnlyOutsideLoop(I, L)) {
+            sinkInstruction(I, L);
+            sunk = true;
+         }
+
+   return sunk;
+}
+
+// Promozione a registro di una locazione loop invariant: le load e le store
+// del loop vengono sostituite da valori SSA, la locazione viene letta una
+// volta nel preheader e scritta una volta in ogni blocco di uscita
+class LoopPromoter : public LoadAndStorePromoter {
+   Value *Pointer;
+   Align Alignment;
+   Loop &L;
+   SmallVectorImpl<BasicBlock*> &Exits;
+   MemorySSAUpdater *MSSAU;
+
+public:
+   LoopPromoter(Value *P, Align A, ArrayRef<const Instruction*> Insts, SSAUpdater &S, Loop &Lp, SmallVectorImpl<BasicBlock*> &E, MemorySSAUpdater *U)
+      : LoadAndStorePromoter(Insts, S), Pointer(P), Alignment(A), L(Lp), Exits(E), MSSAU(U) {}
+
+   void doExtraRewritesBeforeFinalDeletion() override {
+      for (BasicBlock *Exit : Exits) {
+         Value *LiveOut = SSA.GetValueInMiddleOfBlock(Exit);
+
+         // Con un solo predecessore l'SSAUpdater restituisce direttamente il
+         // valore definito nel loop: per la forma LCSSA serve un PHI nell'uscita
+         if (Instruction *I = dyn_cast<Instruction>(LiveOut))
+            if (L.contains(I))   LiveOut = getLCSSAPhi(I, Exit);
+
+         StoreInst *Store = new StoreInst(LiveOut, Pointer, &*Exit -> getFirstInsertionPt());
+         Store -> setAlignment(Alignment);
+
+         if (MSSAU) {
+            MemoryAccess *Access = MSSAU -> createMemoryAccessInBB(Store, nullptr, Exit, MemorySSA::Beginning);
+            MSSAU -> insertDef(cast<MemoryDef>(Access), true);
+         }
+      }
+   }
+
+   void instructionDeleted(Instruction *I) const override {
+      if (MSSAU)  MSSAU -> removeMemoryAccess(I);
+   }
+};
+
+// Raccoglie le load e le store del loop che accedono esattamente alla
+// locazione puntata da P; fallisce se un'altra istruzione può accedervi
+bool collectPromotableAccesses(Value *P, Loop &L, AAResults &AA, DominatorTree &DT, ICFLoopSafetyInfo &SafetyInfo, SmallVectorImpl<Instruction*> &Accesses, Align &Alignment) {
+   Type *AccessType = nullptr;
+   bool StoreExecuted = false;
+   SmallVector<Instruction*> Others{};
+
+   for (BasicBlock *BB : L.blocks())
+      for (Instruction &I : *BB) {
+         if (!I.mayReadOrWriteMemory())   continue;
+
+         Value *Ptr = getLoadStorePointerOperand(&I);
+
+         if (!Ptr || (Ptr != P && !AA.isMustAlias(Ptr, P))) {
+            Others.push_back(&I);
+            continue;
+         }
+
+         LoadInst *Load = dyn_cast<LoadInst>(&I);
+         StoreInst *Store = dyn_cast<StoreInst>(&I);
+
+         if ((Load && !Load -> isSimple()) || (Store && !Store -> isSimple()))   return false;
+         if (AccessType && AccessType != getLoadStoreType(&I))   return false;
+
+         AccessType = getLoadStoreType(&I);
+         Alignment = Accesses.empty() ? getLoadStoreAlignment(&I) : std::min(Alignment, getLoadStoreAlignment(&I));
+         Accesses.push_back(&I);
+
+         // Serve una store eseguita ad ogni ingresso nel loop, altrimenti le
+         // store nei blocchi di uscita introdurrebbero scritture nuove
+         if (Store && SafetyInfo.isGuaranteedToExecute(I, &DT, &L))  StoreExecuted = true;
+      }
+
+   if (!StoreExecuted)  return false;
+
+   const DataLayout &DL = L.getHeader() -> getModule() -> getDataLayout();
+   MemoryLocation Loc(P, LocationSize::precise(DL.getTypeStoreSize(AccessType)));
+
+   for (Instruction *I : Others)
+      if (isModOrRefSet(AA.getModRefInfo(I, Loc)))  return false;
+
+   return true;
+}
+
+bool promoteLoopInvariantMemory(Loop &L, AAResults &AA, DominatorTree &DT, LoopInfo &LI, ScalarEvolution &SE, ICFLoopSafetyInfo &SafetyInfo, MemorySSAUpdater *MSSAU) {
+   BasicBlock *Preheader = L.getLoopPreheader();
+
+   // Una eccezione nel loop renderebbe visibile la locazione non aggiornata
+   if (!Preheader || !L.hasDedicatedExits() || SafetyInfo.anyBlockMayThrow()) return false;
+
+   SmallSetVector<Value*, 8> Pointers{};
+
+   for (BasicBlock *BB : L.blocks())
+      for (Instruction &I : *BB)
+         if (StoreInst *Store = dyn_cast<StoreInst>(&I))
+            if (Store -> isSimple() && L.isLoopInvariant(Store -> getPointerOperand()))
+               Pointers.insert(Store -> getPointerOperand());
+
+   SmallVector<BasicBlock*> Exits{};
+   L.getUniqueExitBlocks(Exits);
+
+   bool promoted = false;
+
+   for (Value *P : Pointers) {
+      SmallVector<Instruction*> Accesses{};
+      Align Alignment;
+
+      if (!collectPromotableAccesses(P, L, AA, DT, SafetyInfo, Accesses, Alignment))  continue;
+
+      SmallVector<PHINode*> NewPHIs{};
+      SSAUpdater SSA(&NewPHIs);
+      SmallVector<const Instruction*> ConstAccesses(Accesses.begin(), Accesses.end());
+      LoopPromoter Promoter(P, Alignment, ConstAccesses, SSA, L, Exits, MSSAU);
+
+      LoadInst *Load = new LoadInst(getLoadStoreType(Accesses.front()), P, P -> getName() + ".promoted", Preheader -> getTerminator());
+      Load -> setAlignment(Alignment);
+
+      if (MSSAU) {
+         MemoryAccess *Access = MSSAU -> createMemoryAccessInBB(Load, nullptr, Preheader, MemorySSA::End);
+         MSSAU -> insertUse(cast<MemoryUse>(Access), true);
+      }
+
+      SSA.AddAvailableValue(Preheader, Load);
+      Promoter.run(Accesses);
+
+      if (Load -> use_empty()) {
+         if (MSSAU)  MSSAU -> removeMemoryAccess(Load);
+         Load -> eraseFromParent();
+      }
+
+      promoted = true;
+   }
+
+   // Gli accessi nei sottoloop vengono sostituiti da valori che possono
+   // essere usati fuori dal sottoloop: servono i PHI nelle sue uscite
+   if (promoted)  formLCSSARecursively(L, DT, &LI, &SE);
+
+   return promoted;
+}
+
+// Branch condizionale del loop (non di un sottoloop) con condizione
+// invariante e successori entrambi nel loop. Se la BFI è disponibile
+// viene scelto il branch eseguito più spesso
+BranchInst *findUnswitchCandidate(Loop &L, LoopInfo &LI, BlockFrequencyInfo *BFI) {
+   BranchInst *Candidate = nullptr;
+   uint64_t CandidateExecutions = 0;
+
+   for (BasicBlock *BB : L.blocks()) {
+      if (LI.getLoopFor(BB) != &L)  continue;
+
+      BranchInst *BI = dyn_cast<BranchInst>(BB -> getTerminator());
+      if (!BI || !BI -> isConditional())  continue;
+
+      Value *Cond = BI -> getCondition();
+      if (isa<Constant>(Cond) || !L.isLoopInvariant(Cond))  continue;
+
+      if (BI -> getSuccessor(0) == BI -> getSuccessor(1))   continue;
+      if (!L.contains(BI -> getSuccessor(0)) || !L.contains(BI -> getSuccessor(1)))  continue;
+
+      uint64_t Executions = getExecutionsPerEntry(BB, L, BFI);
+      if (Executions < UnswitchMinExecutions)  continue;
+
+      if (!Candidate || Executions > CandidateExecutions) {
+         Candidate = BI;
+         CandidateExecutions = Executions;
+      }
+   }
+
+   return Candidate;
+}
+
+// Il loop viene duplicato solo se la sua dimensione rientra nella soglia e
+// se tutte le copie prodotte rientrano nel budget: dopo k unswitching,
+// contati in llvm.loop.icm.unswitch.count, il loop di partenza ha 2^k copie
+bool isUnswitchProfitable(Loop &L, TargetTransformInfo &TTI, AssumptionCache &AC) {
+   SmallPtrSet<const Value*, 32> EphValues{};
+   CodeMetrics::collectEphemeralValues(&L, &AC, EphValues);
+
+   CodeMetrics Metrics;
+   for (BasicBlock *BB : L.blocks())
+      Metrics.analyzeBasicBlock(BB, TTI, EphValues);
+
+   if (Metrics.notDuplicatable || Metrics.convergent)  return false;
+
+   if (!Metrics.NumInsts.isValid() || Metrics.NumInsts > UnswitchThreshold)   return false;
+
+   unsigned Count = getIntLoopAttribute(&L, "llvm.loop.icm.unswitch.count");
+   if (Count >= 16)  return false;
+
+   return Metrics.NumInsts * (2 << Count) <= UnswitchBudget;
+}
+
+// Dopo l'unswitching il branch ha una condizione costante: viene sostituito
+// da un salto incondizionato e i blocchi non più raggiungibili, comprese le
+// uscite e gli eventuali sottoloop, vengono eliminati. I sottoloop della
+// copia non sono ancora noti al pass manager
+void foldUnswitchedBranch(Loop &L, BranchInst *BI, bool Taken, LoopStandardAnalysisResults &LAR, LPMUpdater &LU, MemorySSAUpdater *MSSAU, bool IsClone) {
+   DominatorTree &DT = LAR.DT;
+   LoopInfo &LI = LAR.LI;
+
+   BasicBlock *BB = BI -> getParent();
+   BasicBlock *Live = BI -> getSuccessor(Taken ? 0 : 1);
+   BasicBlock *Dead = BI -> getSuccessor(Taken ? 1 : 0);
+
+   // I PHI con un solo ingresso vengono mantenuti: nelle uscite sono PHI LCSSA
+   Dead -> removePredecessor(BB, true);
+   BranchInst::Create(Live, BI);
+   BI -> eraseFromParent();
+
+   if (MSSAU)  MSSAU -> removeEdge(BB, Dead);
+   DT.applyUpdates({{DominatorTree::Delete, BB, Dead}});
+
+   // Blocchi raggiungibili solo attraverso l'arco eliminato
+   SmallSetVector<BasicBlock*, 8> DeadBlocks{};
+   SmallVector<BasicBlock*> Candidates{Dead};
+
+   while (!Candidates.empty()) {
+      BasicBlock *C = Candidates.pop_back_val();
+      if (DeadBlocks.count(C) || DT.isReachableFromEntry(C))  continue;
+
+      DeadBlocks.insert(C);
+      append_range(Candidates, successors(C));
+   }
+
+   if (DeadBlocks.empty())   return;
+
+   for (BasicBlock *D : DeadBlocks)
+      for (BasicBlock *Succ : successors(D))
+         if (!DeadBlocks.count(Succ))  Succ -> removePredecessor(D, true);
+
+   if (MSSAU)  MSSAU -> removeBlocks(DeadBlocks);
+
+   // Un sottoloop, a qualsiasi profondità, è eliminato se lo è il suo
+   // header: i suoi blocchi sono raggiungibili solo attraverso l'header.
+   // Vengono staccati dal padre solo i più esterni, LI.destroy elimina
+   // anche i loro sottoloop
+   SmallPtrSet<Loop*, 8> DeadLoops{};
+   SmallVector<Loop*> DeadRoots{};
+   for (Loop *Sub : L.getLoopsInPreorder()) {
+      if (Sub == &L || !DeadBlocks.count(Sub -> getHeader()))  continue;
+
+      DeadLoops.insert(Sub);
+      if (!DeadLoops.count(Sub -> getParentLoop()))  DeadRoots.push_back(Sub);
+
+      if (!IsClone)  LU.markLoopAsDeleted(*Sub, Sub -> getName());
+   }
+
+   for (BasicBlock *D : DeadBlocks)
+      LI.removeBlock(D);
+
+   for (Loop *Root : DeadRoots) {
+      Root -> getParentLoop() -> removeChildLoop(Root);
+      LI.destroy(Root);
+   }
+
+   for (BasicBlock *D : DeadBlocks) {
+      for (Instruction &I : *D)
+         if (!I.use_empty())  I.replaceAllUsesWith(PoisonValue::get(I.getType()));
+
+      D -> dropAllReferences();
+   }
+
+   for (BasicBlock *D : DeadBlocks)
+      D -> eraseFromParent();
+
+#ifdef EXPENSIVE_CHECKS
+   LI.verify(DT);
+#endif
+}
+
+// Unswitching di una condizione invariante: il loop viene duplicato e il
+// branch viene spostato nel preheader, che sceglie quale copia eseguire.
+// Nel loop originale la condizione è sempre vera, nella copia sempre falsa.
+// Come in SimpleLoopUnswitch anche le uscite vengono duplicate, così ogni
+// copia ha uscite dedicate; i valori delle due copie si uniscono nei PHI di
+// un blocco successivo alle uscite
+bool unswitchInvariantBranch(Loop &L, LoopStandardAnalysisResults &LAR, LPMUpdater &LU, MemorySSAUpdater *MSSAU) {
+   DominatorTree &DT = LAR.DT;
+   LoopInfo &LI = LAR.LI;
+
+   if (!L.getLoopPreheader() || !L.hasDedicatedExits())   return false;
+
+   BranchInst *BI = findUnswitchCandidate(L, LI, LAR.BFI);
+   if (!BI || !isUnswitchProfitable(L, LAR.TTI, LAR.AC))  return false;
+
+   SmallVector<BasicBlock*> ExitBlocks{};
+   L.getUniqueExitBlocks(ExitBlocks);
+
+   // Le uscite vengono divise dopo i PHI: un blocco EH non può esserlo
+   if (any_of(ExitBlocks, [](BasicBlock *Exit) { return Exit -> isEHPad(); }))  return false;
+
+   LAR.SE.forgetTopmostLoop(&L);
+
+   BasicBlock *Dispatch = L.getLoopPreheader();
+   Value *Cond = BI -> getCondition();
+
+   // Il branch viene eseguito anche quando il loop non lo avrebbe raggiunto:
+   // una condizione poison o undef diventerebbe comportamento indefinito
+   if (!isGuaranteedNotToBeUndefOrPoison(Cond, &LAR.AC, Dispatch -> getTerminator(), &DT))
+      Cond = new FreezeInst(Cond, Cond -> getName() + ".fr", Dispatch -> getTerminator());
+
+   // Ogni uscita contiene solo i PHI LCSSA; il resto del blocco diventa il
+   // punto in cui le due copie si riuniscono
+   SmallVector<BasicBlock*> MergeBlocks{};
+   SmallVector<std::pair<PHINode*, PHINode*>> MergePHIs{};
+   for (BasicBlock *Exit : ExitBlocks) {
+      BasicBlock *Merge = SplitBlock(Exit, Exit -> getFirstNonPHI(), &DT, &LI, MSSAU, Exit -> getName() + ".split");
+      MergeBlocks.push_back(Merge);
+
+      for (PHINode &PN : Exit -> phis()) {
+         LAR.SE.forgetValue(&PN);
+
+         PHINode *MergePN = PHINode::Create(PN.getType(), 2, PN.getName() + ".merge", &Merge -> front());
+         PN.replaceUsesOutsideBlock(MergePN, Exit);
+         MergePN -> addIncoming(&PN, Exit);
+         MergePHIs.push_back({&PN, MergePN});
+      }
+   }
+
+   // Il vecchio preheader diventa il blocco di scelta
+   BasicBlock *Preheader = SplitBlock(Dispatch, Dispatch -> getTerminator(), &DT, &LI, MSSAU);
+
+   ValueToValueMapTy VMap;
+   SmallVector<BasicBlock*> NewBlocks{};
+   Loop *NewLoop = cloneLoopWithPreheader(Preheader, Dispatch, &L, VMap, ".us", &LI, &DT, NewBlocks);
+
+   for (BasicBlock *Exit : ExitBlocks) {
+      BasicBlock *NewExit = CloneBasicBlock(Exit, VMap, ".us", Exit -> getParent());
+      VMap[Exit] = NewExit;
+      NewBlocks.push_back(NewExit);
+
+      if (Loop *ExitLoop = LI.getLoopFor(Exit))  ExitLoop -> addBasicBlockToLoop(NewExit, LI);
+   }
+
+   remapInstructionsInBlocks(NewBlocks, VMap);
+
+   BasicBlock *NewPreheader = cast<BasicBlock>(VMap[Preheader]);
+   Dispatch -> getTerminator() -> eraseFromParent();
+   BranchInst::Create(Preheader, NewPreheader, Cond, Dispatch);
+
+   SmallVector<DominatorTree::UpdateType> Updates{};
+   Updates.push_back({DominatorTree::Insert, Dispatch, NewPreheader});
+
+   for (unsigned i = 0; i < ExitBlocks.size(); i++) {
+      BasicBlock *Exit = ExitBlocks[i];
+      BasicBlock *NewExit = cast<BasicBlock>(VMap[Exit]);
+      BasicBlock *Merge = MergeBlocks[i];
+
+      BasicBlock *IDom = DT.getNode(Exit) -> getIDom() -> getBlock();
+      DT.addNewBlock(NewExit, cast<BasicBlock>(VMap[IDom]));
+      Updates.push_back({DominatorTree::Insert, NewExit, Merge});
+   }
+
+   // I PHI di unione ricevono i valori anche dalla copia delle uscite
+   for (auto &[PN, MergePN] : MergePHIs)
+      MergePN -> addIncoming(VMap[PN], cast<BasicBlock>(VMap[PN -> getParent()]));
+
+   // I blocchi fuori dal loop dominati da un blocco del loop (diversi dalle
+   // uscite) e i blocchi di unione sono ora raggiungibili da entrambe le copie
+   SmallVector<DomTreeNode*> OutsideChildren{};
+   for (BasicBlock *BB : L.blocks()) {
+      for (DomTreeNode *Child : DT.getNode(BB) -> children()) {
+         if (!L.contains(Child -> getBlock()) && !is_contained(ExitBlocks, Child -> getBlock()))  OutsideChildren.push_back(Child);
+      }
+   }
+   for (BasicBlock *Merge : MergeBlocks)
+      OutsideChildren.push_back(DT.getNode(Merge));
+
+   for (DomTreeNode *Child : OutsideChildren)
+      DT.changeImmediateDominator(Child, DT.getNode(Dispatch));
+
+   if (MSSAU) {
+      LoopBlocksRPO LBRPO(&L);
+      LBRPO.perform(&LI);
+      MSSAU -> updateForClonedLoop(LBRPO, ExitBlocks, VMap, true);
+      MSSAU -> applyInsertUpdates(Updates, DT);
+   }
+
+   // In ogni copia il branch viene eliminato insieme al ramo non eseguito
+   BranchInst *NewBI = cast<BranchInst>(VMap[BI]);
+   foldUnswitchedBranch(L, BI, true, LAR, LU, MSSAU, false);
+   foldUnswitchedBranch(*NewLoop, NewBI, false, LAR, LU, MSSAU, true);
+
+   // Le due copie condividono il conteggio, che limita le copie successive
+   unsigned Count = getIntLoopAttribute(&L, "llvm.loop.icm.unswitch.count") + 1;
+   addStringMetadataToLoop(&L, "llvm.loop.icm.unswitch.count", Count);
+   addStringMetadataToLoop(NewLoop, "llvm.loop.icm.unswitch.count", Count);
+
+   // Il loop originale viene visitato di nuovo per gli altri branch invarianti
+   LU.addSiblingLoops({NewLoop});
+   LU.revisitCurrentLoop();
+
+   return true;
+}
+
+// Load e store con indirizzo invariante che restano nel loop solo perché
+// un'altra istruzione del loop potrebbe accedere alla stessa memoria
+bool hasAliasBlockedAccesses(Loop &L, AAResults &AA) {
+   for (BasicBlock *BB : L.blocks())
+      for (Instruction &I : *BB) {
+         if (!isa<LoadInst>(I) && !isa<StoreInst>(I))  continue;
+         if (!L.isLoopInvariant(getLoadStorePointerOperand(&I)))  continue;
+
+         if (isa<LoadInst>(I) && isClobberedInLoop(I, L, AA, nullptr))  return true;
+
+         if (isa<StoreInst>(I)) {
+            MemoryLocation Loc = MemoryLocation::get(&I);
+
+            for (BasicBlock *Other : L.blocks())
+               for (Instruction &W : *Other)
+                  if (&W != &I && isModOrRefSet(AA.getModRefInfo(&W, Loc)))  return true;
+         }
+      }
+
+   return false;
+}
+
+// Versioning del loop: nel preheader vengono controllati a runtime gli
+// intervalli di memoria acceduti dai puntatori; se non si sovrappongono
+// viene eseguito L (getVersionedLoop), le cui istruzioni vengono marcate
+// noalias e possono quindi essere spostate, altrimenti la copia .lver.orig
+// (getNonVersionedLoop) con gli accessi originali.
+// LoopVersioning non aggiorna MemorySSA, quindi il versioning è possibile
+// solo all'interno di una pipeline loop(...): il PassBuilder rifiuta
+// loop-mssa(loop-icm<versioning>) e con il solo nome del passo sceglie loop
+bool versionLoopForAliasing(Loop &L, LoopStandardAnalysisResults &LAR, LPMUpdater &LU) {
+   if (LAR.MSSA || !L.isInnermost() || !L.isLoopSimplifyForm() || !L.getExitBlock())   return false;
+   if (hasLICMVersioningTransformation(&L) & TM_Disable) return false;
+
+   if (!hasAliasBlockedAccesses(L, LAR.AA))  return false;
+
+   LoopAccessInfoManager LAIs(LAR.SE, LAR.AA, LAR.DT, LAR.LI, nullptr);
+   const LoopAccessInfo &LAI = LAIs.getInfo(L);
+
+   if (!LAI.canVectorizeMemory() || LAI.hasConvergentOp())  return false;
+
+   const auto &Checks = LAI.getRuntimePointerChecking() -> getChecks();
+   if (Checks.empty() || Checks.size() > VersioningMaxChecks)  return false;
+
+   LoopVersioning LVer(LAI, Checks, &L, &LAR.LI, &LAR.DT, &LAR.SE);
+   LVer.versionLoop();
+   LVer.annotateLoopWithNoAlias();
+
+   // Nessuna delle due copie viene versionata di nuovo
+   addStringMetadataToLoop(LVer.getVersionedLoop(), "llvm.loop.licm_versioning.disable", 1);
+   addStringMetadataToLoop(LVer.getNonVersionedLoop(), "llvm.loop.licm_versioning.disable", 1);
+
+   LU.addSiblingLoops({LVer.getNonVersionedLoop()});
+
+   return true;
+}
+
+// Il passo può essere eseguito anche su loop che non sono in forma
+// semplificata: il preheader serve come destinazione delle istruzioni
+// spostate, le uscite dedicate e la forma LCSSA servono a sinking e
+// promozione
+bool prepareLoop(Loop &L, DominatorTree &DT, LoopInfo &LI, ScalarEvolution &SE, MemorySSAUpdater *MSSAU) {
+   bool changed = false;
+
+   if (!L.getLoopPreheader() && InsertPreheaderForLoop(&L, &DT, &LI, MSSAU, true))
+      changed = true;
+
+   if (!L.hasDedicatedExits() && formDedicatedExitBlocks(&L, &DT, &LI, MSSAU, true))
+      changed = true;
+
+   if (!L.isLCSSAForm(DT) && formLCSSA(L, DT, &LI, &SE))
+      changed = true;
+
+   if (changed)   SE.forgetLoop(&L);
+
+   return changed;
+}
+
+// DominatorTree, LoopInfo e ScalarEvolution vengono aggiornati ad ogni
+// modifica del CFG (preheader, guardia, versioning, unswitching), MemorySSA
+// durante gli spostamenti
+PreservedAnalyses preservedAnalyses(MemorySSA *MSSA) {
+   PreservedAnalyses PA = getLoopPassPreservedAnalyses();
+   if (MSSA)   PA.preserve<MemorySSAAnalysis>();
+   return PA;
 }
 
 PreservedAnalyses LoopICM::run(Loop &L, LoopAnalysisManager &LAM, LoopStandardAnalysisResults &LAR, LPMUpdater &LU) {
    // printStats(L);
 
+   resetState();
+
    // Recupero dell'albero di dominanza
    DominatorTree &DT = LAR.DT;
 
+   // Alias analysis e MemorySSA per le load e le call readonly
+   AAResults &AA = LAR.AA;
+   MemorySSA *MSSA = LAR.MSSA;
+   std::unique_ptr<MemorySSAUpdater> MSSAU;
+   if (MSSA)   MSSAU = std::make_unique<MemorySSAUpdater>(MSSA);
+
+   bool modified = false;
+
+   // Preheader, uscite dedicate e forma LCSSA vengono create se mancano
+   if (prepareLoop(L, DT, LAR.LI, LAR.SE, MSSAU.get()))
+      modified = true;
+
+   if (!L.getLoopPreheader()) return modified ? preservedAnalyses(MSSA) : PreservedAnalyses::all();
+
+   // Con il versioning le load e le store bloccate dall'alias analysis
+   // possono essere spostate nella copia senza alias
+   if (Opts.Versioning && versionLoopForAliasing(L, LAR, LU))
+      modified = true;
+
+   ICFLoopSafetyInfo SafetyInfo;
+   SafetyInfo.computeLoopSafetyInfo(&L);
+
+   // Costo delle istruzioni eseguite speculativamente
+   TargetTransformInfo &TTI = LAR.TTI;
+
    // Recupero dei blocchi di uscita
-   L.getExitBlocks(exitBlocks);
-   setOutBlocks();
+   L.getUniqueExitBlocks(exitBlocks);
+   setOutBlocks(DT);
 
-   for (BasicBlock *BB : L.blocks()) {
-      for (Instruction &I : *BB) { 
-         if (I.isBinaryOp() && isLoopInvariantInstruction(I, L)) {     
-            // Se l'istruzione non viene usata, la elimino
-            if (std::distance(I.user_begin(), I.user_end()) == 0) {
-               InstructionsToDelete.insert(&I);          
-               continue;
-            }    
-            
-            // Se l'istruzione è loop invariant e movable, la si salva
-            if (codeMotionCheck(&I, DT)) {
-               loopInvariantInstructionSet.insert(&I);
-               loopInvariantInstructionVector.push_back(&I);
-            }
-         }
-      }
-   }
+   // Le catene con operandi invarianti vengono raggruppate prima della ricerca
+   if (reassociateInvariants(L, DT, LAR.SE))
+      modified = true;
+
+   findLoopInvariants(L, DT, TTI, AA, MSSA, SafetyInfo, Opts.Guarded);
+   limitRegisterPressure(L, TTI);
 
    if (std::size(loopInvariantInstructionVector) > 0 || std::size(InstructionsToDelete) > 0) {
       // printInfo();
-      action(L);
-      return PreservedAnalyses::none();
+      action(L, DT, LAR.LI, AA, MSSA, MSSAU.get(), LAR.BFI);
+      modified = true;
+   }
+
+   // Le istruzioni che possono generare trap vengono spostate sotto guardia
+   if (hoistGuardedInstructions(L, DT, LAR.LI, LAR.SE, TTI, MSSAU.get()))
+      modified = true;
+
+   // I divisori spostati nel preheader sono ora invarianti
+   if (replaceInvariantDivisions(L, LAR.SE, LAR.BFI))
+      modified = true;
+
+   // Le istruzioni usate solo dopo il loop vengono spostate nelle uscite
+   if (sinkLoopOutputs(L, DT))
+      modified = true;
+
+   // Dopo gli spostamenti le istruzioni del loop sono cambiate
+   SafetyInfo.computeLoopSafetyInfo(&L);
+
+   if (promoteLoopInvariantMemory(L, AA, DT, LAR.LI, LAR.SE, SafetyInfo, MSSAU.get()))
+      modified = true;
+
+   // Le condizioni invarianti rimaste nel loop vengono spostate nel preheader
+   if (unswitchInvariantBranch(L, LAR, LU, MSSAU.get()))
+      modified = true;
+
+   if (modified) {
+      // Le istruzioni spostate non sono più varianti nel loop
+      LAR.SE.forgetLoopDispositions();
+      return preservedAnalyses(MSSA);
    }
   
   return PreservedAnalyses::all();
 }
+
+void LoopICM::printPipeline(raw_ostream &OS, function_ref<StringRef(StringRef)> MapClassName2PassName) {
+   static_cast<PassInfoMixin<LoopICM> *>(this) -> printPipeline(OS, MapClassName2PassName);
+
+   if (Opts.Versioning && Opts.Guarded) OS << "<versioning;guarded>";
+   else if (Opts.Versioning) OS << "<versioning>";
+   else if (Opts.Guarded) OS << "<guarded>";
+}
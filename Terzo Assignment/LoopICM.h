@@ -6,9 +6,23 @@
 
 namespace llvm {
 
+struct LoopICMOptions {
+    // Versioning del loop con controlli di alias a runtime
+    bool Versioning = false;
+
+    // Spostamento sotto guardia delle istruzioni che possono generare trap
+    bool Guarded = false;
+};
+
 class LoopICM : public PassInfoMixin<LoopICM> {
+    LoopICMOptions Opts;
+
 public:
+    LoopICM(LoopICMOptions Opts = {}) : Opts(Opts) {}
+
     PreservedAnalyses run(Loop &L, LoopAnalysisManager &LAM, LoopStandardAnalysisResults &LAR, LPMUpdater &LU);
+
+    void printPipeline(raw_ostream &OS, function_ref<StringRef(StringRef)> MapClassName2PassName);
 };
 }
 
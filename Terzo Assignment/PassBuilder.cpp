@@ -934,6 +934,40 @@ Expected<LICMOptions> parseLICMOptions(StringRef Params) {
   return Result;
 }
 
+Expected<LoopICMOptions> parseLoopICMOptions(StringRef Params) {
+  LoopICMOptions Result;
+  while (!Params.empty()) {
+    StringRef ParamName;
+    std::tie(ParamName, Params) = Params.split(';');
+
+    bool Enable = !ParamName.consume_front("no-");
+    if (ParamName == "versioning") {
+      Result.Versioning = Enable;
+    } else if (ParamName == "guarded") {
+      Result.Guarded = Enable;
+    } else {
+      return make_error<StringError>(
+          formatv("invalid LoopICM pass parameter '{0}' ", ParamName).str(),
+          inconvertibleErrorCode());
+    }
+  }
+  return Result;
+}
+
+// LoopVersioning does not update MemorySSA, so loop-icm<versioning> needs a
+// loop pipeline without it.
+bool isLoopICMVersioning(StringRef Name) {
+  if (!checkParametrizedPassName(Name, "loop-icm"))
+    return false;
+
+  auto Params = parsePassParameters(parseLoopICMOptions, Name, "loop-icm");
+  if (!Params) {
+    consumeError(Params.takeError());
+    return false;
+  }
+  return Params->Versioning;
+}
+
 Expected<std::pair<bool, bool>> parseLoopRotateOptions(StringRef Params) {
   std::pair<bool, bool> Result = {true, false};
   while (!Params.empty()) {
@@ -1248,6 +1282,11 @@ static bool isLoopPassName(StringRef Name, CallbacksT &Callbacks,
     return true;
   }
 
+  if (checkParametrizedPassName(Name, "loop-icm")) {
+    UseMemorySSA = !isLoopICMVersioning(Name);
+    return true;
+  }
+
 #define LOOP_PASS(NAME, CREATE_PASS)                                           \
   if (Name == NAME)                                                            \
     return true;
@@ -1647,8 +1686,15 @@ Error PassBuilder::parseFunctionPass(FunctionPassManager &FPM,
         return Err;
       // Add the nested pass manager with the appropriate adaptor.
       bool UseMemorySSA = (Name == "loop-mssa");
+      if (UseMemorySSA && llvm::any_of(InnerPipeline, [](auto Pipeline) {
+            return isLoopICMVersioning(Pipeline.Name);
+          }))
+        return make_error<StringError>(
+            "loop-icm<versioning> cannot run in a loop-mssa pipeline",
+            inconvertibleErrorCode());
       bool UseBFI = llvm::any_of(InnerPipeline, [](auto Pipeline) {
-        return Pipeline.Name.contains("simple-loop-unswitch");
+        return Pipeline.Name.contains("simple-loop-unswitch") ||
+               Pipeline.Name.contains("loop-icm");
       });
       bool UseBPI = llvm::any_of(InnerPipeline, [](auto Pipeline) {
         return Pipeline.Name == "loop-predication";
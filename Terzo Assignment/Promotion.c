@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+int k = 3;
+
+void foo(int *restrict a, int *restrict sum, int n) {
+  int i = 0;
+
+  do {
+    *sum = *sum + a[i] * k;
+    i = i + 1;
+  } while (i < n);
+}
+
+int main() {
+  int a[4] = {1, 2, 3, 4}, sum = 0;
+
+  foo(a, &sum, 4);
+  printf("%d\n", sum);
+  return 0;
+}
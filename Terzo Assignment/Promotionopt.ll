@@ -0,0 +1,60 @@
+; ModuleID = '../TEST/Promotion.bc'
+source_filename = "../TEST/Promotion.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@k = dso_local global i32 3, align 4
+@__const.main.a = private unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 16
+@.str = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
+
+define dso_local void @foo(ptr noalias noundef %0, ptr noalias noundef %1, i32 noundef %2) {
+  %4 = load i32, ptr @k, align 4
+  %.promoted = load i32, ptr %1, align 4
+  br label %5
+
+5:                                                ; preds = %13, %3
+  %6 = phi i32 [ %.promoted, %3 ], [ %11, %13 ]
+  %.0 = phi i32 [ 0, %3 ], [ %12, %13 ]
+  %7 = sext i32 %.0 to i64
+  %8 = getelementptr inbounds i32, ptr %0, i64 %7
+  %9 = load i32, ptr %8, align 4
+  %10 = mul nsw i32 %9, %4
+  %11 = add nsw i32 %6, %10
+  %12 = add nsw i32 %.0, 1
+  br label %13
+
+13:                                               ; preds = %5
+  %14 = icmp slt i32 %12, %2
+  br i1 %14, label %5, label %15
+
+15:                                               ; preds = %13
+  %.lcssa = phi i32 [ %11, %13 ]
+  store i32 %.lcssa, ptr %1, align 4
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [4 x i32], align 16
+  %2 = alloca i32, align 4
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 16, i1 false)
+  store i32 0, ptr %2, align 4
+  %3 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %3, ptr noundef %2, i32 noundef 4)
+  %4 = load i32, ptr %2, align 4
+  %5 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %4)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
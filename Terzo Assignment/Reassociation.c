@@ -0,0 +1,14 @@
+#include <stdio.h>
+
+void foo(int *a, int n, int b, int c) {
+  for (int i = 0; i < n; i++)
+    a[i] = (i + b) + c;
+}
+
+int main() {
+  int a[8];
+
+  foo(a, 8, 10, 20);
+  printf("%d,%d,%d,%d\n", a[0], a[3], a[5], a[7]);
+  return 0;
+}
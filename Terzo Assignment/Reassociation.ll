@@ -0,0 +1,58 @@
+; ModuleID = '../TEST/Reassociation.bc'
+source_filename = "../TEST/Reassociation.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2, i32 noundef %3) {
+  br label %5
+
+5:                                                ; preds = %12, %4
+  %.0 = phi i32 [ 0, %4 ], [ %13, %12 ]
+  %6 = icmp slt i32 %.0, %1
+  br i1 %6, label %7, label %14
+
+7:                                                ; preds = %5
+  %8 = add nsw i32 %.0, %2
+  %9 = add nsw i32 %8, %3
+  %10 = sext i32 %.0 to i64
+  %11 = getelementptr inbounds i32, ptr %0, i64 %10
+  store i32 %9, ptr %11, align 4
+  br label %12
+
+12:                                               ; preds = %7
+  %13 = add nsw i32 %.0, 1
+  br label %5
+
+14:                                               ; preds = %5
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [8 x i32], align 16
+  %2 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %2, i32 noundef 8, i32 noundef 10, i32 noundef 20)
+  %3 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 0
+  %4 = load i32, ptr %3, align 16
+  %5 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 3
+  %6 = load i32, ptr %5, align 4
+  %7 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 5
+  %8 = load i32, ptr %7, align 4
+  %9 = getelementptr inbounds [8 x i32], ptr %1, i64 0, i64 7
+  %10 = load i32, ptr %9, align 4
+  %11 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %4, i32 noundef %6, i32 noundef %8, i32 noundef %10)
+  ret i32 0
+}
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
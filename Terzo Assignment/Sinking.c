@@ -0,0 +1,21 @@
+#include <stdio.h>
+
+int foo(int *a, int n, int c) {
+  int i = 0, s = 0, t;
+
+  do {
+    s = s + a[i];
+    t = s * c + 3;
+    i = i + 1;
+  } while (i < n);
+
+  return t;
+}
+
+int main() {
+  int a[5] = {1, 2, 3, 4, 5};
+
+  printf("%d\n", foo(a, 5, 2));
+  printf("%d\n", foo(a, 3, 4));
+  return 0;
+}
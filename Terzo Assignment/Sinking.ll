@@ -0,0 +1,56 @@
+; ModuleID = '../TEST/Sinking.bc'
+source_filename = "../TEST/Sinking.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__const.main.a = private unnamed_addr constant [5 x i32] [i32 1, i32 2, i32 3, i32 4, i32 5], align 16
+@.str = private unnamed_addr constant [4 x i8] c"%d\0A\00", align 1
+
+define dso_local i32 @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2) {
+  br label %4
+
+4:                                                ; preds = %12, %3
+  %.01 = phi i32 [ 0, %3 ], [ %8, %12 ]
+  %.0 = phi i32 [ 0, %3 ], [ %11, %12 ]
+  %5 = sext i32 %.0 to i64
+  %6 = getelementptr inbounds i32, ptr %0, i64 %5
+  %7 = load i32, ptr %6, align 4
+  %8 = add nsw i32 %.01, %7
+  %9 = mul nsw i32 %8, %2
+  %10 = add nsw i32 %9, 3
+  %11 = add nsw i32 %.0, 1
+  br label %12
+
+12:                                               ; preds = %4
+  %13 = icmp slt i32 %11, %1
+  br i1 %13, label %4, label %14
+
+14:                                               ; preds = %12
+  ret i32 %10
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [5 x i32], align 16
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 20, i1 false)
+  %2 = getelementptr inbounds [5 x i32], ptr %1, i64 0, i64 0
+  %3 = call i32 @foo(ptr noundef %2, i32 noundef 5, i32 noundef 2)
+  %4 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %3)
+  %5 = getelementptr inbounds [5 x i32], ptr %1, i64 0, i64 0
+  %6 = call i32 @foo(ptr noundef %5, i32 noundef 3, i32 noundef 4)
+  %7 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %6)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
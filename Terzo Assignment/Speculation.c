@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+void foo(int *a, int n, int m, int c, int d) {
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j++) {
+      if (a[j] > 0)
+        a[j] = a[j] + c * 4;
+      else
+        a[j] = a[j] - c / d;
+    }
+  }
+}
+
+int main() {
+  int a[4] = {1, 2, 3, 4};
+
+  foo(a, 3, 4, 2, 0);
+  printf("%d,%d,%d,%d\n", a[0], a[1], a[2], a[3]);
+  return 0;
+}
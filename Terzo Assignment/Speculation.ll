@@ -0,0 +1,101 @@
+; ModuleID = '../TEST/Speculation.bc'
+source_filename = "../TEST/Speculation.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__const.main.a = private unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 16
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2, i32 noundef %3, i32 noundef %4) {
+  br label %6
+
+6:                                                ; preds = %36, %5
+  %.01 = phi i32 [ 0, %5 ], [ %37, %36 ]
+  %7 = icmp slt i32 %.01, %1
+  br i1 %7, label %8, label %38
+
+8:                                                ; preds = %6
+  br label %9
+
+9:                                                ; preds = %33, %8
+  %.0 = phi i32 [ 0, %8 ], [ %34, %33 ]
+  %10 = icmp slt i32 %.0, %2
+  br i1 %10, label %11, label %35
+
+11:                                               ; preds = %9
+  %12 = sext i32 %.0 to i64
+  %13 = getelementptr inbounds i32, ptr %0, i64 %12
+  %14 = load i32, ptr %13, align 4
+  %15 = icmp sgt i32 %14, 0
+  br i1 %15, label %16, label %24
+
+16:                                               ; preds = %11
+  %17 = sext i32 %.0 to i64
+  %18 = getelementptr inbounds i32, ptr %0, i64 %17
+  %19 = load i32, ptr %18, align 4
+  %20 = mul nsw i32 %3, 4
+  %21 = add nsw i32 %19, %20
+  %22 = sext i32 %.0 to i64
+  %23 = getelementptr inbounds i32, ptr %0, i64 %22
+  store i32 %21, ptr %23, align 4
+  br label %32
+
+24:                                               ; preds = %11
+  %25 = sext i32 %.0 to i64
+  %26 = getelementptr inbounds i32, ptr %0, i64 %25
+  %27 = load i32, ptr %26, align 4
+  %28 = sdiv i32 %3, %4
+  %29 = sub nsw i32 %27, %28
+  %30 = sext i32 %.0 to i64
+  %31 = getelementptr inbounds i32, ptr %0, i64 %30
+  store i32 %29, ptr %31, align 4
+  br label %32
+
+32:                                               ; preds = %24, %16
+  br label %33
+
+33:                                               ; preds = %32
+  %34 = add nsw i32 %.0, 1
+  br label %9
+
+35:                                               ; preds = %9
+  br label %36
+
+36:                                               ; preds = %35
+  %37 = add nsw i32 %.01, 1
+  br label %6
+
+38:                                               ; preds = %6
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [4 x i32], align 16
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 16, i1 false)
+  %2 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %2, i32 noundef 3, i32 noundef 4, i32 noundef 2, i32 noundef 0)
+  %3 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  %4 = load i32, ptr %3, align 16
+  %5 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 1
+  %6 = load i32, ptr %5, align 4
+  %7 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 2
+  %8 = load i32, ptr %7, align 8
+  %9 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 3
+  %10 = load i32, ptr %9, align 4
+  %11 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %4, i32 noundef %6, i32 noundef %8, i32 noundef %10)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
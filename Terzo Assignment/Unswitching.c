@@ -0,0 +1,19 @@
+#include <stdio.h>
+
+void foo(int *a, int n, int flag) {
+  for (int i = 0; i < n; i++) {
+    if (flag)
+      a[i] = a[i] * 2;
+    else
+      a[i] = a[i] + 1;
+  }
+}
+
+int main() {
+  int a[4] = {1, 2, 3, 4};
+
+  foo(a, 4, 1);
+  foo(a, 4, 0);
+  printf("%d,%d,%d,%d\n", a[0], a[1], a[2], a[3]);
+  return 0;
+}
@@ -0,0 +1,113 @@
+; ModuleID = '../TEST/Unswitching.bc'
+source_filename = "../TEST/Unswitching.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__const.main.a = private unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 16
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, i32 noundef %1, i32 noundef %2) {
+  %4 = icmp ne i32 %2, 0
+  br i1 %4, label %.split1, label %.split1.us
+
+.split1.us:                                       ; preds = %3
+  br label %5
+
+5:                                                ; preds = %16, %.split1.us
+  %.0.us = phi i32 [ 0, %.split1.us ], [ %17, %16 ]
+  %6 = icmp slt i32 %.0.us, %1
+  br i1 %6, label %7, label %32
+
+7:                                                ; preds = %5
+  br label %8
+
+8:                                                ; preds = %7
+  %9 = sext i32 %.0.us to i64
+  %10 = getelementptr inbounds i32, ptr %0, i64 %9
+  %11 = load i32, ptr %10, align 4
+  %12 = add nsw i32 %11, 1
+  %13 = sext i32 %.0.us to i64
+  %14 = getelementptr inbounds i32, ptr %0, i64 %13
+  store i32 %12, ptr %14, align 4
+  br label %15
+
+15:                                               ; preds = %8
+  br label %16
+
+16:                                               ; preds = %15
+  %17 = add nsw i32 %.0.us, 1
+  br label %5, !llvm.loop !6
+
+.split1:                                          ; preds = %3
+  br label %18
+
+18:                                               ; preds = %29, %.split1
+  %.0 = phi i32 [ 0, %.split1 ], [ %30, %29 ]
+  %19 = icmp slt i32 %.0, %1
+  br i1 %19, label %20, label %31
+
+20:                                               ; preds = %18
+  br label %21
+
+21:                                               ; preds = %20
+  %22 = sext i32 %.0 to i64
+  %23 = getelementptr inbounds i32, ptr %0, i64 %22
+  %24 = load i32, ptr %23, align 4
+  %25 = mul nsw i32 %24, 2
+  %26 = sext i32 %.0 to i64
+  %27 = getelementptr inbounds i32, ptr %0, i64 %26
+  store i32 %25, ptr %27, align 4
+  br label %28
+
+28:                                               ; preds = %21
+  br label %29
+
+29:                                               ; preds = %28
+  %30 = add nsw i32 %.0, 1
+  br label %18, !llvm.loop !8
+
+31:                                               ; preds = %18
+  br label %.split
+
+.split:                                           ; preds = %32, %31
+  ret void
+
+32:                                               ; preds = %5
+  br label %.split
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [4 x i32], align 16
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 16, i1 false)
+  %2 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %2, i32 noundef 4, i32 noundef 1)
+  %3 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %3, i32 noundef 4, i32 noundef 0)
+  %4 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  %5 = load i32, ptr %4, align 16
+  %6 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 1
+  %7 = load i32, ptr %6, align 4
+  %8 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 2
+  %9 = load i32, ptr %8, align 8
+  %10 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 3
+  %11 = load i32, ptr %10, align 4
+  %12 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %5, i32 noundef %7, i32 noundef %9, i32 noundef %11)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.icm.unswitch.count", i32 1}
+!8 = distinct !{!8, !7}
@@ -0,0 +1,19 @@
+#include <stdio.h>
+
+void foo(int *a, int *b, int n) {
+  int i = 0;
+
+  do {
+    a[i] = a[i] + *b;
+    i = i + 1;
+  } while (i < n);
+}
+
+int main() {
+  int a[4] = {1, 2, 3, 4}, b = 5;
+
+  foo(a, &b, 4);
+  foo(a, &a[2], 4);
+  printf("%d,%d,%d,%d\n", a[0], a[1], a[2], a[3]);
+  return 0;
+}
@@ -0,0 +1,116 @@
+; ModuleID = '../TEST/Versioning.bc'
+source_filename = "../TEST/Versioning.c"
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@__const.main.a = private unnamed_addr constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 16
+@.str = private unnamed_addr constant [13 x i8] c"%d,%d,%d,%d\0A\00", align 1
+
+define dso_local void @foo(ptr noundef %0, ptr noundef %1, i32 noundef %2) {
+.lver.check:
+  %smax = call i32 @llvm.smax.i32(i32 %2, i32 1)
+  %3 = add nsw i32 %smax, -1
+  %4 = zext i32 %3 to i64
+  %5 = add nuw nsw i64 %4, 1
+  %scevgep = getelementptr i32, ptr %0, i64 %5
+  %scevgep1 = getelementptr i32, ptr %1, i64 1
+  %bound0 = icmp ult ptr %0, %scevgep1
+  %bound1 = icmp ult ptr %1, %scevgep
+  %found.conflict = and i1 %bound0, %bound1
+  br i1 %found.conflict, label %.ph.lver.orig, label %.ph
+
+.ph.lver.orig:                                    ; preds = %.lver.check
+  br label %6
+
+6:                                                ; preds = %15, %.ph.lver.orig
+  %.0.lver.orig = phi i32 [ 0, %.ph.lver.orig ], [ %14, %15 ]
+  %7 = sext i32 %.0.lver.orig to i64
+  %8 = getelementptr inbounds i32, ptr %0, i64 %7
+  %9 = load i32, ptr %8, align 4
+  %10 = load i32, ptr %1, align 4
+  %11 = add nsw i32 %9, %10
+  %12 = sext i32 %.0.lver.orig to i64
+  %13 = getelementptr inbounds i32, ptr %0, i64 %12
+  store i32 %11, ptr %13, align 4
+  %14 = add nsw i32 %.0.lver.orig, 1
+  br label %15
+
+15:                                               ; preds = %6
+  %16 = icmp slt i32 %14, %2
+  br i1 %16, label %6, label %.loopexit, !llvm.loop !6
+
+.ph:                                              ; preds = %.lver.check
+  %17 = load i32, ptr %1, align 4, !alias.scope !8
+  br label %18
+
+18:                                               ; preds = %26, %.ph
+  %.0 = phi i32 [ 0, %.ph ], [ %25, %26 ]
+  %19 = sext i32 %.0 to i64
+  %20 = getelementptr inbounds i32, ptr %0, i64 %19
+  %21 = load i32, ptr %20, align 4, !alias.scope !11, !noalias !8
+  %22 = add nsw i32 %21, %17
+  %23 = sext i32 %.0 to i64
+  %24 = getelementptr inbounds i32, ptr %0, i64 %23
+  store i32 %22, ptr %24, align 4, !alias.scope !11, !noalias !8
+  %25 = add nsw i32 %.0, 1
+  br label %26
+
+26:                                               ; preds = %18
+  %27 = icmp slt i32 %25, %2
+  br i1 %27, label %18, label %.loopexit4, !llvm.loop !13
+
+.loopexit:                                        ; preds = %15
+  br label %28
+
+.loopexit4:                                       ; preds = %26
+  br label %28
+
+28:                                               ; preds = %.loopexit4, %.loopexit
+  ret void
+}
+
+define dso_local i32 @main() {
+  %1 = alloca [4 x i32], align 16
+  %2 = alloca i32, align 4
+  call void @llvm.memcpy.p0.p0.i64(ptr align 16 %1, ptr align 16 @__const.main.a, i64 16, i1 false)
+  store i32 5, ptr %2, align 4
+  %3 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  call void @foo(ptr noundef %3, ptr noundef %2, i32 noundef 4)
+  %4 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  %5 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 2
+  call void @foo(ptr noundef %4, ptr noundef %5, i32 noundef 4)
+  %6 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 0
+  %7 = load i32, ptr %6, align 16
+  %8 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 1
+  %9 = load i32, ptr %8, align 4
+  %10 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 2
+  %11 = load i32, ptr %10, align 8
+  %12 = getelementptr inbounds [4 x i32], ptr %1, i64 0, i64 3
+  %13 = load i32, ptr %12, align 4
+  %14 = call i32 (ptr, ...) @printf(ptr noundef @.str, i32 noundef %7, i32 noundef %9, i32 noundef %11, i32 noundef %13)
+  ret i32 0
+}
+
+declare void @llvm.memcpy.p0.p0.i64(ptr noalias nocapture writeonly, ptr noalias nocapture readonly, i64, i1 immarg)
+
+declare i32 @printf(ptr noundef, ...)
+
+declare i32 @llvm.smax.i32(i32, i32)
+
+!llvm.module.flags = !{!0, !1, !2, !3, !4}
+!llvm.ident = !{!5}
+
+!0 = !{i32 1, !"wchar_size", i32 4}
+!1 = !{i32 7, !"PIC Level", i32 2}
+!2 = !{i32 7, !"PIE Level", i32 2}
+!3 = !{i32 7, !"uwtable", i32 2}
+!4 = !{i32 7, !"frame-pointer", i32 2}
+!5 = !{!"clang version 17.0.6"}
+!6 = distinct !{!6, !7}
+!7 = !{!"llvm.loop.licm_versioning.disable", i32 1}
+!8 = !{!9}
+!9 = distinct !{!9, !10}
+!10 = distinct !{!10, !"LVerDomain"}
+!11 = !{!12}
+!12 = distinct !{!12, !10}
+!13 = distinct !{!13, !7}